@@ -0,0 +1,68 @@
+#!/bin/sh
+# Copyright 2010 Jason Stredwick
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Loads the sample historic dump plain and in each compressed form given,
+#   and checks that every form gives the same reports, and that a compressed
+#   dump cut short is reported as damaged rather than as a bad line.
+#
+# usage: compressed.sh <TreeLoader> [extension ...]     e.g. gz zst
+
+BIN=`cd \`dirname $1\` && pwd`/`basename $1`
+shift
+DATA=`cd \`dirname $0\`/Data && pwd`
+WORK=`mktemp -d`
+trap 'rm -rf $WORK' EXIT
+FAILED=0
+
+run()
+{
+  mkdir -p $WORK/$1
+  cp $DATA/sample_detail $WORK/$1/
+  cp $2 $WORK/$1/
+  (cd $WORK/$1 && $BIN -h `basename $2` -d sample_detail -t 1000 \
+                       -v -g -ncstem -b -r -n > stdout 2>&1)
+}
+
+run plain $DATA/sample_historic
+if ! grep -q "Gamma = " $WORK/plain/stdout
+then
+  echo "plain: failed to load"
+  FAILED=1
+fi
+
+for EXT in "$@"
+do
+  run $EXT $DATA/sample_historic.$EXT
+  for REPORT in `cd $WORK/plain && ls sample_detail.*`
+  do
+    if ! cmp -s $WORK/plain/$REPORT $WORK/$EXT/$REPORT
+    then
+      echo "$EXT: $REPORT differs"
+      FAILED=1
+    fi
+  done
+
+  head -c 6000 $DATA/sample_historic.$EXT > $WORK/cut.$EXT
+  run cut$EXT $WORK/cut.$EXT
+  if ! grep -q "Could not decompress historic file." $WORK/cut$EXT/stdout ||
+     grep -q "error - " $WORK/cut$EXT/stdout
+  then
+    echo "$EXT: damaged file not reported"
+    FAILED=1
+  fi
+done
+
+if [ $FAILED -eq 0 ]; then echo "Compressed input checks passed."; fi
+exit $FAILED
@@ -0,0 +1,147 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Times AncestorIndex on random pairs of nodes against walking Up from
+//   both nodes until they meet, and checks that both find the same common
+//   ancestors.  The tree is grown the way an Avida population grows, each
+//   organism born to one of the recent ones, so lineages are deep.
+//
+// usage: AncestorBenchmark [nodes] [pairs]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Organisms/Interface/SimpleOrganism.h"
+#include "PhylogeneticTree/Interface/AncestorIndex.h"
+#include "PhylogeneticTree/Interface/Tree.h"
+#include "PhylogeneticTree/Interface/TreeIterator.h"
+#include "Support/Interface/random.h"
+
+using namespace std;
+using namespace PhylogeneticTree;
+
+const double Seconds(void);
+TreeIterator WalkUp(TreeIterator, TreeIterator);
+
+int main(int argc, char **argv)
+{
+  const unsigned int howMany =
+    (argc > 1) ? static_cast<unsigned int>(atoi(argv[1])) : 1000000;
+  const unsigned int pairs =
+    (argc > 2) ? static_cast<unsigned int>(atoi(argv[2])) : 2000000;
+  // Walking up is slow, so it only answers every so many of the pairs.
+  const unsigned int walkEvery = 20;
+
+  RandomNumberGenerator rng(1);
+  vector<iOrganism*> organisms;
+  organisms.reserve(howMany);
+  organisms.push_back(new SimpleOrganism(0, -1));
+  for(unsigned int i = 1; i < howMany; ++i)
+  {
+    const unsigned int recent = (i < 2000) ? i : 2000;
+    const unsigned int parent = (rng.GetUInt(100) != 0)
+                                ? i - 1 - rng.GetUInt(recent)
+                                : rng.GetUInt(i);
+    organisms.push_back(new SimpleOrganism(static_cast<int>(i),
+                                           static_cast<int>(parent)));
+  }
+
+  bool same = true;
+  {
+    const Tree tree(organisms);
+
+    vector<TreeIterator> nodes;
+    nodes.reserve(howMany);
+    long depths = 0;
+    for(TreeIterator i = tree.Begin(); i != tree.End(); ++i)
+    {
+      nodes.push_back(i);
+      depths += i.GetDepth();
+    }
+
+    vector<unsigned int> picks(2 * static_cast<size_t>(pairs));
+    for(size_t k = 0; k < picks.size(); ++k)
+    {
+      picks[k] = rng.GetUInt(static_cast<unsigned int>(nodes.size()));
+    }
+
+    double start = Seconds();
+    const AncestorIndex ancestors(tree);
+    const double build = Seconds() - start;
+
+    start = Seconds();
+    vector<TreeIterator> found;
+    found.reserve(pairs);
+    for(unsigned int k = 0; k < pairs; ++k)
+    {
+      found.push_back(ancestors.FindCommonAncestor(nodes[picks[2 * k]],
+                                                   nodes[picks[2 * k + 1]]));
+    }
+    const double query = Seconds() - start;
+
+    start = Seconds();
+    unsigned int walked = 0;
+    for(unsigned int k = 0; k < pairs; k += walkEvery, ++walked)
+    {
+      const TreeIterator meet = WalkUp(nodes[picks[2 * k]],
+                                       nodes[picks[2 * k + 1]]);
+      same = same && meet == found[k];
+    }
+    const double walk = Seconds() - start;
+
+    cout << "Common ancestors of random pairs, " << nodes.size()
+         << " nodes of average depth "
+         << depths / static_cast<long>(nodes.size()) << endl;
+    cout << "  AncestorIndex: build " << build << " s, " << pairs
+         << " pairs " << query << " s, "
+         << query * 1e9 / pairs << " ns/pair" << endl;
+    cout << "  walking Up:    " << walked << " pairs " << walk << " s, "
+         << walk * 1e9 / walked << " ns/pair" << endl;
+  }
+
+  for(size_t i = 0; i < organisms.size(); ++i) { delete organisms[i]; }
+
+  if(!same)
+  {
+    cout << "  AncestorIndex and walking Up found different ancestors."
+         << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+const double Seconds(void)
+{
+  return chrono::duration<double>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TreeIterator WalkUp(TreeIterator a, TreeIterator b)
+{
+  // Bring both to the same depth, then climb together until they meet.
+  while(a.GetDepth() > b.GetDepth()) { a.Up(); }
+  while(b.GetDepth() > a.GetDepth()) { b.Up(); }
+  while(a != b)
+  {
+    a.Up();
+    b.Up();
+  }
+
+  return a;
+}
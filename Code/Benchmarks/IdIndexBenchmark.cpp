@@ -0,0 +1,179 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Times IdIndex, in its direct array mode and its hash mode, against the
+//   std::map from organism id to slot that tree building used before, and
+//   checks that every lookup agrees.
+//
+// usage: IdIndexBenchmark [ids]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "PhylogeneticTree/Interface/IdIndex.h"
+#include "Support/Interface/random.h"
+
+using namespace std;
+using namespace PhylogeneticTree;
+
+const double Seconds(void);
+const bool Compare(const char * const name, const vector<int> &ids,
+                   const vector<int> &lookups);
+
+int main(int argc, char **argv)
+{
+  const unsigned int howMany =
+    (argc > 1) ? static_cast<unsigned int>(atoi(argv[1])) : 2000000;
+
+  // Avida hands out ids in order from zero, which IdIndex keeps in an
+  //   array.  Ids spread out and below zero push it into the hash table.
+  //   Ids a power of two apart share their low bits, which a hash has to
+  //   mix in from the high bits to keep them apart.
+  vector<int> dense(howMany);
+  vector<int> spread(howMany);
+  vector<int> strided(howMany);
+  for(unsigned int i = 0; i < howMany; ++i)
+  {
+    dense[i] = static_cast<int>(i);
+    spread[i] = static_cast<int>(i) * 97 - 1000003;
+    strided[i] = static_cast<int>(i) * 1024 - (1 << 30);
+  }
+
+  // Look up every id in a random order, then as many ids that are not
+  //   present.
+  RandomNumberGenerator rng(1);
+  vector<unsigned int> order(howMany);
+  for(unsigned int i = 0; i < howMany; ++i) { order[i] = i; }
+  for(unsigned int i = howMany; i > 1; --i)
+  {
+    const unsigned int j = rng.GetUInt(i);
+    const unsigned int swap = order[i - 1];
+    order[i - 1] = order[j];
+    order[j] = swap;
+  }
+
+  vector<int> denseLookups;
+  vector<int> spreadLookups;
+  vector<int> stridedLookups;
+  denseLookups.reserve(2 * howMany);
+  spreadLookups.reserve(2 * howMany);
+  stridedLookups.reserve(2 * howMany);
+  for(unsigned int i = 0; i < howMany; ++i)
+  {
+    denseLookups.push_back(dense[order[i]]);
+    spreadLookups.push_back(spread[order[i]]);
+    stridedLookups.push_back(strided[order[i]]);
+  }
+  for(unsigned int i = 0; i < howMany; ++i)
+  {
+    denseLookups.push_back(static_cast<int>(howMany + order[i]));
+    spreadLookups.push_back(spread[order[i]] + 1);
+    stridedLookups.push_back(strided[order[i]] + 512);
+  }
+
+  cout << "IdIndex and std::map with " << howMany << " ids, "
+       << 2 * howMany << " lookups (half missing)" << endl;
+  bool same = Compare("dense ids (direct)", dense, denseLookups);
+  same = Compare("spread ids (hash)", spread, spreadLookups) && same;
+  same = Compare("ids 1024 apart (hash)", strided, stridedLookups) && same;
+  if(!same)
+  {
+    cout << "  IdIndex and std::map disagree." << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+const double Seconds(void)
+{
+  return chrono::duration<double>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const bool Compare(const char * const name, const vector<int> &ids,
+                   const vector<int> &lookups)
+{
+  const unsigned int howMany = static_cast<unsigned int>(ids.size());
+
+  // Each is timed a few times and the fastest kept, since the first pass
+  //   over fresh memory also pays for mapping it in.  Each map and index
+  //   is gone before the next is built.
+  const int rounds = 3;
+  double mapInsert = 0;
+  double mapFind = 0;
+  double indexInsert = 0;
+  double indexFind = 0;
+  vector<unsigned int> mapFound(lookups.size());
+  vector<unsigned int> indexFound(lookups.size());
+  for(int r = 0; r < rounds; ++r)
+  {
+    double start = Seconds();
+    map<int, unsigned int> idToSlot;
+    for(unsigned int i = 0; i < howMany; ++i)
+    {
+      idToSlot.insert(make_pair(ids[i], i));
+    }
+    const double insert = Seconds() - start;
+
+    start = Seconds();
+    for(size_t i = 0; i < lookups.size(); ++i)
+    {
+      map<int, unsigned int>::const_iterator found =
+        idToSlot.find(lookups[i]);
+      mapFound[i] = (found == idToSlot.end()) ? IdIndex::Missing
+                                              : found->second;
+    }
+    const double find = Seconds() - start;
+
+    if(r == 0 || insert < mapInsert) { mapInsert = insert; }
+    if(r == 0 || find < mapFind)     { mapFind = find; }
+  }
+
+  for(int r = 0; r < rounds; ++r)
+  {
+    double start = Seconds();
+    IdIndex index;
+    index.Reserve(howMany);
+    for(unsigned int i = 0; i < howMany; ++i)
+    {
+      index.Insert(ids[i], i);
+    }
+    const double insert = Seconds() - start;
+
+    start = Seconds();
+    for(size_t i = 0; i < lookups.size(); ++i)
+    {
+      indexFound[i] = index.Find(lookups[i]);
+    }
+    const double find = Seconds() - start;
+
+    if(r == 0 || insert < indexInsert) { indexInsert = insert; }
+    if(r == 0 || find < indexFind)     { indexFind = find; }
+  }
+
+  const double perLookup = 1e9 / static_cast<double>(lookups.size());
+  cout << "  " << name << ", fastest of " << rounds << endl;
+  cout << "    std::map: insert " << mapInsert << " s, find "
+       << mapFind * perLookup << " ns/lookup" << endl;
+  cout << "    IdIndex:  insert " << indexInsert << " s, find "
+       << indexFind * perLookup << " ns/lookup" << endl;
+
+  return mapFound == indexFound;
+}
@@ -0,0 +1,240 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Times AvidaOrganism::Parse against the stream extraction it replaced, on
+//   generated historic dump lines, and checks that both read the same
+//   fields.
+//
+// usage: ParseBenchmark [lines]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Organisms/Interface/Avida.h"
+#include "Support/Interface/random.h"
+
+using namespace std;
+
+// The fields of one line as the stream path reads them.
+struct StreamRecord
+{
+  int id;
+  int parentId;
+  int parentDistance;
+  int currentAlive;
+  int totalExisted;
+  int genomeLength;
+  double merit;
+  double gestationTime;
+  double fitness;
+  int updateBorn;
+  int updateDeactivated;
+  int phyloDepth;
+  char *genome;
+};
+
+// Reads a line in place, as Parse did before the scanners.
+class LineBuffer : public streambuf
+{
+public:
+  LineBuffer(const char * const begin, const char * const end)
+  {
+    setg(const_cast<char*>(begin), const_cast<char*>(begin),
+         const_cast<char*>(end));
+    return;
+  }
+};
+
+const double Seconds(void);
+const string MakeLines(const unsigned int howMany);
+const bool StreamParse(const char * const begin, const char * const end,
+                       StreamRecord &record);
+const bool SameFields(const StreamRecord &, const AvidaOrganism &);
+
+int main(int argc, char **argv)
+{
+  const unsigned int howMany =
+    (argc > 1) ? static_cast<unsigned int>(atoi(argv[1])) : 200000;
+  const int repeats = 3;
+
+  const string text = MakeLines(howMany);
+  const char * const textEnd = text.data() + text.size();
+
+  // Check first that both paths read every line the same way.
+  unsigned int differ = 0;
+  for(const char *line = text.data(); line < textEnd; )
+  {
+    const char *lineEnd =
+      static_cast<const char*>(memchr(line, '\n', textEnd - line));
+    if(lineEnd == 0) { lineEnd = textEnd; }
+
+    StreamRecord record;
+    AvidaOrganism *organism = AvidaOrganism::Parse(line, lineEnd);
+    if(!StreamParse(line, lineEnd, record) || organism == 0 ||
+       !SameFields(record, *organism))
+    {
+      ++differ;
+    }
+    delete [] record.genome;
+    delete organism;
+
+    line = lineEnd + 1;
+  }
+
+  double streamSeconds = 0;
+  double scanSeconds = 0;
+  // Summing a field keeps the work from being optimized away.
+  double streamSum = 0;
+  double scanSum = 0;
+  for(int r = 0; r < repeats; ++r)
+  {
+    double start = Seconds();
+    for(const char *line = text.data(); line < textEnd; )
+    {
+      const char *lineEnd =
+        static_cast<const char*>(memchr(line, '\n', textEnd - line));
+      if(lineEnd == 0) { lineEnd = textEnd; }
+
+      StreamRecord record;
+      if(StreamParse(line, lineEnd, record)) { streamSum += record.merit; }
+      delete [] record.genome;
+
+      line = lineEnd + 1;
+    }
+    streamSeconds += Seconds() - start;
+
+    start = Seconds();
+    for(const char *line = text.data(); line < textEnd; )
+    {
+      const char *lineEnd =
+        static_cast<const char*>(memchr(line, '\n', textEnd - line));
+      if(lineEnd == 0) { lineEnd = textEnd; }
+
+      AvidaOrganism *organism = AvidaOrganism::Parse(line, lineEnd);
+      if(organism != 0) { scanSum += organism->GetMerit(); }
+      delete organism;
+
+      line = lineEnd + 1;
+    }
+    scanSeconds += Seconds() - start;
+  }
+
+  const double lines = static_cast<double>(howMany) * repeats;
+  const double megabytes = static_cast<double>(text.size()) * repeats /
+                           (1024.0 * 1024.0);
+  cout << "Parse " << howMany << " lines (" << text.size() / 1024
+       << " KB), " << repeats << " times" << endl;
+  cout << "  stream:   " << streamSeconds * 1e9 / lines << " ns/line, "
+       << megabytes / streamSeconds << " MB/s" << endl;
+  cout << "  scanners: " << scanSeconds * 1e9 / lines << " ns/line, "
+       << megabytes / scanSeconds << " MB/s" << endl;
+  cout << "  speedup:  " << streamSeconds / scanSeconds << "x" << endl;
+  if(streamSum != scanSum || differ != 0)
+  {
+    cout << "  " << differ << " lines were read differently." << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+const double Seconds(void)
+{
+  return chrono::duration<double>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const string MakeLines(const unsigned int howMany)
+{
+  // Lines look like those of an Avida historic dump: ids in order, small
+  //   counts, fractional merit, gestation and fitness, and a genome.
+  RandomNumberGenerator rng(1);
+  const char letters[] = "abcdefghijklmnopqrstuvwxyz";
+
+  string text;
+  char genome[128];
+  char line[512];
+  for(unsigned int i = 0; i < howMany; ++i)
+  {
+    const unsigned int length = rng.GetUInt(50, 120);
+    for(unsigned int g = 0; g < length; ++g)
+    {
+      genome[g] = letters[rng.GetUInt(26)];
+    }
+    genome[length] = '\0';
+
+    const int born = static_cast<int>(i / 4);
+    snprintf(line, sizeof(line),
+             "%u %d %u %d %u %u %.6g %.6g %.6g %d %d %u %s\n",
+             i, (i == 0) ? -1 : static_cast<int>(rng.GetUInt(i)),
+             rng.GetUInt(4), 0, rng.GetUInt(1, 9), length,
+             rng.GetDouble(1000), rng.GetDouble(400), rng.GetDouble(3),
+             born, born + 100, rng.GetUInt(1, 500), genome);
+    text += line;
+  }
+
+  return text;
+}
+
+const bool StreamParse(const char * const begin, const char * const end,
+                       StreamRecord &record)
+{
+  LineBuffer buffer(begin, end);
+  istream ss(&buffer);
+
+  record.genome = 0;
+  ss >> record.id >> record.parentId >> record.parentDistance
+     >> record.currentAlive >> record.totalExisted >> record.genomeLength
+     >> record.merit >> record.gestationTime >> record.fitness
+     >> record.updateBorn >> record.updateDeactivated >> record.phyloDepth;
+  if(ss.fail()) { return false; }
+
+  // The old parser read the genome into a buffer and copied it.
+  char genome[2048];
+  ss >> genome;
+  if(ss.fail() && !ss.eof()) { return false; }
+
+  const size_t length = strlen(genome);
+  record.genome = new char[length + 1];
+  memcpy(record.genome, genome, length + 1);
+
+  return static_cast<int>(length) == record.genomeLength;
+}
+
+const bool SameFields(const StreamRecord &record,
+                      const AvidaOrganism &organism)
+{
+  return record.id                == organism.GetId() &&
+         record.parentId          == organism.GetParentId() &&
+         record.parentDistance    == organism.GetParentDistance() &&
+         record.currentAlive      == organism.GetCurrentAlive() &&
+         record.totalExisted      == organism.GetTotalExisted() &&
+         record.genomeLength      == organism.GetGenomeLength() &&
+         record.merit             == organism.GetMerit() &&
+         record.gestationTime     == organism.GetGestationTime() &&
+         record.fitness           == organism.GetFitness() &&
+         record.updateBorn        == organism.GetUpdateBorn() &&
+         record.updateDeactivated == organism.GetUpdateDeactivated() &&
+         record.phyloDepth        == organism.GetPhyloDepth() &&
+         strcmp(record.genome, organism.GetGenome()) == 0;
+}
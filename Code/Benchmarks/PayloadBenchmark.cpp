@@ -0,0 +1,136 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Times a walk over the whole tree that reads each node's id, parent id,
+//   birth time and alive flag, once from the fields the node keeps and
+//   once through GetData, and checks that both read the same values.
+//
+// usage: PayloadBenchmark [nodes] [rounds]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "Organisms/Interface/SimpleOrganism.h"
+#include "PhylogeneticTree/Interface/iOrganism.h"
+#include "PhylogeneticTree/Interface/iTreeNode.h"
+#include "PhylogeneticTree/Interface/Tree.h"
+#include "PhylogeneticTree/Interface/TreeIterator.h"
+#include "Support/Interface/random.h"
+
+using namespace std;
+using namespace PhylogeneticTree;
+
+const double Seconds(void);
+const double ReadNodes(const Tree&);
+const double ReadData(const Tree&);
+
+int main(int argc, char **argv)
+{
+  const unsigned int howMany =
+    (argc > 1) ? static_cast<unsigned int>(atoi(argv[1])) : 1000000;
+  const unsigned int rounds =
+    (argc > 2) ? static_cast<unsigned int>(atoi(argv[2])) : 5;
+
+  // Grown the same way as in AncestorBenchmark.
+  RandomNumberGenerator rng(1);
+  vector<iOrganism*> organisms;
+  organisms.reserve(howMany);
+  organisms.push_back(new SimpleOrganism(0, -1));
+  for(unsigned int i = 1; i < howMany; ++i)
+  {
+    const unsigned int recent = (i < 2000) ? i : 2000;
+    const unsigned int parent = (rng.GetUInt(100) != 0)
+                                ? i - 1 - rng.GetUInt(recent)
+                                : rng.GetUInt(i);
+    organisms.push_back(new SimpleOrganism(static_cast<int>(i),
+                                           static_cast<int>(parent)));
+  }
+
+  bool same = true;
+  {
+    const Tree tree(organisms);
+
+    // Each timing is the fastest of the rounds.
+    double nodeTime = 0.0, dataTime = 0.0;
+    for(unsigned int r = 0; r < rounds; ++r)
+    {
+      double start = Seconds();
+      const double fromNodes = ReadNodes(tree);
+      const double nodeRound = Seconds() - start;
+
+      start = Seconds();
+      const double fromData = ReadData(tree);
+      const double dataRound = Seconds() - start;
+
+      same = same && fromNodes == fromData;
+      if(r == 0 || nodeRound < nodeTime) { nodeTime = nodeRound; }
+      if(r == 0 || dataRound < dataTime) { dataTime = dataRound; }
+    }
+
+    cout << "Reading 4 fields of every node, " << tree.Size()
+         << " nodes, fastest of " << rounds << endl;
+    cout << "  node fields: " << nodeTime * 1000 << " ms, "
+         << nodeTime * 1e9 / tree.Size() << " ns/node" << endl;
+    cout << "  GetData:     " << dataTime * 1000 << " ms, "
+         << dataTime * 1e9 / tree.Size() << " ns/node" << endl;
+  }
+
+  for(size_t i = 0; i < organisms.size(); ++i) { delete organisms[i]; }
+
+  if(!same)
+  {
+    cout << "  The node fields and GetData read different values." << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+const double Seconds(void)
+{
+  return chrono::duration<double>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const double ReadNodes(const Tree &tree)
+{
+  double sum = 0.0;
+  const TreeIterator end = tree.End();
+  for(TreeIterator i = tree.Begin(); i != end; ++i)
+  {
+    const iTreeNode *node = *i;
+    sum += node->GetBirthTime() + node->GetId() + node->GetParentId() +
+           (node->GetIsAlive() ? 1 : 0);
+  }
+
+  return sum;
+}
+
+const double ReadData(const Tree &tree)
+{
+  double sum = 0.0;
+  const TreeIterator end = tree.End();
+  for(TreeIterator i = tree.Begin(); i != end; ++i)
+  {
+    const iOrganism &data = (*i)->GetData();
+    sum += data.GetBirthTime() + data.GetId() + data.GetParentId() +
+           (data.GetIsAlive() ? 1 : 0);
+  }
+
+  return sum;
+}
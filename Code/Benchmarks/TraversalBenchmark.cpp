@@ -0,0 +1,220 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Times full ++ and -- walks of star-like trees, where a node has many
+//   children, against the same walks finding each sibling by searching the
+//   parent's children as TreeIterator did before, and checks that both
+//   visit the same nodes.
+//
+// usage: TraversalBenchmark [leaves]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "Organisms/Interface/SimpleOrganism.h"
+#include "PhylogeneticTree/Interface/Tree.h"
+#include "PhylogeneticTree/Interface/TreeIterator.h"
+#include "PhylogeneticTree/Interface/iTreeNode.h"
+
+using namespace std;
+using namespace PhylogeneticTree;
+
+// Each node's children as the plain list of pointers the old search went
+//   through.
+typedef unordered_map<const iTreeNode*, vector<const iTreeNode*> >
+  ChildLists;
+
+const double Seconds(void);
+const bool Walk(const unsigned int groups, const unsigned int leaves);
+const size_t FindChild(const ChildLists &, const TreeIterator &parent,
+                       const TreeIterator &child);
+void NextBySearch(const ChildLists &, TreeIterator &);
+void PreviousBySearch(const ChildLists &, TreeIterator &);
+
+int main(int argc, char **argv)
+{
+  const unsigned int leaves =
+    (argc > 1) ? static_cast<unsigned int>(atoi(argv[1])) : 20000;
+
+  cout << "Full ++ and -- walks, by child position and by search" << endl;
+  bool same = Walk(0, leaves);
+  same = Walk(0, leaves * 2) && same;
+  same = Walk(100, leaves / 50) && same;
+  if(!same)
+  {
+    cout << "  The walks visited different nodes." << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+const double Seconds(void)
+{
+  return chrono::duration<double>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A star has every leaf under the root; with groups, the root has that many
+//   children with the leaves under each of them.
+const bool Walk(const unsigned int groups, const unsigned int leaves)
+{
+  vector<iOrganism*> organisms;
+  int id = 0;
+  organisms.push_back(new SimpleOrganism(id++, -1));
+  if(groups == 0)
+  {
+    for(unsigned int i = 0; i < leaves; ++i)
+    {
+      organisms.push_back(new SimpleOrganism(id++, 0));
+    }
+  }
+  for(unsigned int g = 0; g < groups; ++g)
+  {
+    const int parent = id++;
+    organisms.push_back(new SimpleOrganism(parent, 0));
+    for(unsigned int i = 0; i < leaves; ++i)
+    {
+      organisms.push_back(new SimpleOrganism(id++, parent));
+    }
+  }
+
+  bool same = true;
+  {
+    const Tree tree(organisms);
+    const TreeIterator end = tree.End();
+
+    double start = Seconds();
+    vector<const iTreeNode*> forward;
+    forward.reserve(organisms.size());
+    for(TreeIterator i = tree.Begin(); i != end; ++i)
+    {
+      forward.push_back(*i);
+    }
+    const double next = Seconds() - start;
+
+    start = Seconds();
+    vector<const iTreeNode*> backward;
+    backward.reserve(organisms.size());
+    for(TreeIterator i = tree.Root(); i != end; --i)
+    {
+      backward.push_back(*i);
+    }
+    const double previous = Seconds() - start;
+
+    ChildLists lists;
+    for(TreeIterator i = tree.Begin(); i != end; ++i)
+    {
+      vector<const iTreeNode*> &list = lists[*i];
+      const ChildRange children = i.Children();
+      for(ChildRange::const_iterator c = children.begin();
+          c != children.end(); ++c)
+      {
+        list.push_back(**c);
+      }
+    }
+
+    start = Seconds();
+    size_t k = 0;
+    for(TreeIterator i = tree.Begin(); i != end; NextBySearch(lists, i), ++k)
+    {
+      same = same && k < forward.size() && *i == forward[k];
+    }
+    same = same && k == forward.size();
+    const double nextSearch = Seconds() - start;
+
+    start = Seconds();
+    k = 0;
+    for(TreeIterator i = tree.Root(); i != end;
+        PreviousBySearch(lists, i), ++k)
+    {
+      same = same && k < backward.size() && *i == backward[k];
+    }
+    same = same && k == backward.size();
+    const double previousSearch = Seconds() - start;
+
+    cout << "  ";
+    if(groups == 0) { cout << "star of " << leaves << " leaves"; }
+    else { cout << groups << " x " << leaves << " leaves"; }
+    cout << endl;
+    cout << "    position: ++ " << next << " s, -- " << previous << " s"
+         << endl;
+    cout << "    search:   ++ " << nextSearch << " s, -- " << previousSearch
+         << " s" << endl;
+  }
+
+  for(size_t i = 0; i < organisms.size(); ++i) { delete organisms[i]; }
+
+  return same;
+}
+
+const size_t FindChild(const ChildLists &lists, const TreeIterator &parent,
+                       const TreeIterator &child)
+{
+  const vector<const iTreeNode*> &list = lists.find(*parent)->second;
+  size_t k = 0;
+  while(k < list.size() && list[k] != *child) { ++k; }
+
+  return k;
+}
+
+void NextBySearch(const ChildLists &lists, TreeIterator &i)
+{
+  const TreeIterator child = i;
+  i.Up();
+  if(*i == 0) { return; }
+
+  // Having left the last child, the parent comes next.
+  const ChildRange children = i.Children();
+  const size_t k = FindChild(lists, i, child);
+  if(k + 1 >= children.Size()) { return; }
+
+  // Otherwise the next sibling's left-most leaf.
+  i = children[k + 1];
+  while((*i)->HowManyChildren() > 0) { i = i.Children()[0]; }
+
+  return;
+}
+
+void PreviousBySearch(const ChildLists &lists, TreeIterator &i)
+{
+  // A node with children steps to its last child.
+  if((*i)->HowManyChildren() > 0)
+  {
+    const ChildRange children = i.Children();
+    i = children[children.Size() - 1];
+    return;
+  }
+
+  // Otherwise up past every first child, then to the previous sibling.
+  TreeIterator child = i;
+  size_t k = 0;
+  do
+  {
+    child = i;
+    i.Up();
+    if(*i == 0) { return; }
+    k = FindChild(lists, i, child);
+  }
+  while(k == 0);
+
+  i = i.Children()[k - 1];
+
+  return;
+}
@@ -17,12 +17,18 @@
 #ifndef __Organisms_Interface_Avida_h__
 #define __Organisms_Interface_Avida_h__
 
+#include <cstddef>
+#include <functional>
 #include <istream>
 #include <vector>
 #include <set>
 #include <utility>
 
 #include "PhylogeneticTree/Interface/iOrganism.h"
+#include "PhylogeneticTree/Interface/OrganismTable.h"
+#include "Support/Interface/Arena.h"
+
+class ThreadPool;
 
 class AvidaOrganism : public PhylogeneticTree::iOrganism
 {
@@ -56,8 +62,18 @@ public:
 
   // Builds a new organism from a string constructed from it's data.
   static AvidaOrganism* Parse(const char * const data) throw(int);
+  // Same as above, but the data is the range [begin, end) which does not
+  //   need to be null terminated, e.g. a line inside a MappedFile.
+  static AvidaOrganism* Parse(const char * const begin,
+                              const char * const end) throw(int);
+  // Same as above, but the organism and its genome are placed in the arena.
+  //   Such organisms must not be deleted; they go when the arena is cleared.
+  static AvidaOrganism* Parse(const char * const begin,
+                              const char * const end,
+                              Arena &arena) throw(int);
 
   friend const bool operator==(const AvidaOrganism &, const AvidaOrganism &);
+  friend class AvidaOrganismTable;
 
 private:
   int id;
@@ -73,14 +89,146 @@ private:
   int updateDeactivated;
   int phyloDepth;
   char *genome;
+  bool ownsGenome;
 
   void Assign(const AvidaOrganism &);
+
+  // Reads the fields of the line [begin, end) into data except for the
+  //   genome, which is not copied.  Instead genome is set to where it starts
+  //   within the line.  Returns false for blank lines and comments.
+  //   Only the AvidaOrganismTable columns selected by columns are converted;
+  //   the rest are skipped over, only checking that they are present.
+  static const bool ParseFields(const char * const begin,
+                                const char * const end,
+                                const unsigned int columns,
+                                AvidaOrganism &data,
+                                const char *&genome) throw(int);
+};
+
+// Column store of Avida organisms.  Adds the remaining Avida fields to those
+//   kept by OrganismTable, with every genome packed into an arena that is
+//   released all at once by Clear.
+//
+// Which of those fields are loaded can be selected up front so that the
+//   others are never converted or stored, and a row filter can keep records
+//   from being added at all.  Both apply to every row parsed afterwards.
+class AvidaOrganismTable : public PhylogeneticTree::OrganismTable
+{
+public:
+  // The optional columns.  Id, parent id, birth update and alive status are
+  //   always loaded since every tree needs them.
+  enum Column
+  {
+    NoColumns                = 0,
+    ParentDistanceColumn     = 1 << 0,
+    CurrentAliveColumn       = 1 << 1,
+    TotalExistedColumn       = 1 << 2,
+    GenomeLengthColumn       = 1 << 3,
+    MeritColumn              = 1 << 4,
+    GestationTimeColumn      = 1 << 5,
+    FitnessColumn            = 1 << 6,
+    UpdateDeactivatedColumn  = 1 << 7,
+    PhyloDepthColumn         = 1 << 8,
+    GenomeColumn             = 1 << 9,
+    AllColumns               = (1 << 10) - 1
+  };
+
+  // Decides whether a parsed record is kept.  The columns that were not
+  //   selected, and the genome, are not set in the organism it is given.
+  //   When loading on several threads it is called from all of them.
+  typedef std::function<const bool(const AvidaOrganism &)> RowFilter;
+
+private:
+  unsigned int columns;
+  RowFilter    rowFilter;
+
+  std::vector<int>         parentDistances;
+  std::vector<int>         currentAlive;
+  std::vector<int>         totalExisted;
+  std::vector<int>         genomeLengths;
+  std::vector<double>      merits;
+  std::vector<double>      gestationTimes;
+  std::vector<double>      fitnesses;
+  std::vector<int>         updateDeactivated;
+  std::vector<int>         phyloDepths;
+  std::vector<const char*> genomes;
+  Arena                    genomeArena;
+
+public:
+  AvidaOrganismTable(void);
+  ~AvidaOrganismTable(void);
+
+  // Both throw 1 unless the table is empty.
+  void               SelectColumns(const unsigned int) throw(int);
+  void               SetRowFilter(const RowFilter &) throw(int);
+  const unsigned int GetColumns(void) const;
+  const RowFilter   &GetRowFilter(void) const;
+
+  // Parses the line [begin, end) straight into a new row.  Returns false,
+  //   adding nothing, for blank lines and comments and throws the same
+  //   errors as AvidaOrganism::Parse, except for fields that are skipped.
+  //   Records rejected by the row filter are not added but true is still
+  //   returned.
+  const bool Parse(const char * const begin,
+                   const char * const end) throw(int);
+  // Appends every row of the other table to this one.
+  void       Append(const AvidaOrganismTable &);
+  // Same as Append, but the other table is left empty and its genomes are
+  //   moved rather than copied.
+  void       Take(AvidaOrganismTable &);
+  void       Clear(void);
+  void       Reserve(const unsigned int);
+
+  // Only the columns that were selected may be read.
+  const int    GetParentDistance(const unsigned int i)    const;
+  const int    GetCurrentAlive(const unsigned int i)      const;
+  const int    GetTotalExisted(const unsigned int i)      const;
+  const int    GetGenomeLength(const unsigned int i)      const;
+  const double GetMerit(const unsigned int i)             const;
+  const double GetGestationTime(const unsigned int i)     const;
+  const double GetFitness(const unsigned int i)           const;
+  const int    GetUpdateBorn(const unsigned int i)        const;
+  const int    GetUpdateDeactivated(const unsigned int i) const;
+  const int    GetPhyloDepth(const unsigned int i)        const;
+  const char * GetGenome(const unsigned int i)            const;
+
+private:
+  void AppendColumns(const AvidaOrganismTable &);
 };
 
 const bool operator==(const AvidaOrganism &, const AvidaOrganism &);
 void LoadAvidaOrganisms(std::vector<PhylogeneticTree::iOrganism*> &organisms,
                         std::istream &in,
                         const bool isDetail) throw(std::pair<int,int>);
+// Loads organisms directly from the characters in [begin, end), such as a
+//   MappedFile, without copying each line into a separate buffer.
+void LoadAvidaOrganisms(std::vector<PhylogeneticTree::iOrganism*> &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail) throw(std::pair<int,int>);
+// Same as above, but [begin, end) is split into newline aligned chunks that
+//   are parsed on the threads of the pool.  Organisms are still added in
+//   file order and the first bad line is reported exactly as above.
+void LoadAvidaOrganisms(std::vector<PhylogeneticTree::iOrganism*> &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail,
+                        ThreadPool &pool) throw(std::pair<int,int>);
+// The same three loaders, filling a column store instead of creating an
+//   object for every organism.
+void LoadAvidaOrganisms(AvidaOrganismTable &organisms,
+                        std::istream &in,
+                        const bool isDetail) throw(std::pair<int,int>);
+void LoadAvidaOrganisms(AvidaOrganismTable &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail) throw(std::pair<int,int>);
+void LoadAvidaOrganisms(AvidaOrganismTable &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail,
+                        ThreadPool &pool) throw(std::pair<int,int>);
 std::set<int> CheckForDuplicateIds(const std::vector<PhylogeneticTree::iOrganism*> &) throw(int);
+std::set<int> CheckForDuplicateIds(const PhylogeneticTree::OrganismTable &);
 
 #endif // __Organisms_Interface_Avida_h__
@@ -15,10 +15,16 @@
  */
 
 #include <cstring>
-#include <sstream>
+#include <cstdlib>
+#include <climits>
+#include <cmath>
+#include <new>
+#include <string>
 
 #include "Organisms/Interface/Avida.h"
 
+#include "Support/Interface/ThreadPool.h"
+
 using namespace std;
 using namespace PhylogeneticTree;
 
@@ -26,6 +32,87 @@ void LoadSingleAvidaOrganism(vector<iOrganism*> &iorganisms,
                              istream &in,
                              const bool isDetail) throw(int);
 
+// The loaders are written once for any container of organisms.  These
+//   overloads are the only parts that differ between a vector of organism
+//   objects and an AvidaOrganismTable.
+//
+// LoadLine adds the organism on the line [begin, end) and checks that it
+//   belongs in the file it came from.  Returns false for lines without one.
+const bool LoadLine(vector<iOrganism*> &organisms,
+                    const char * const begin,
+                    const char * const end,
+                    const bool isDetail) throw(int);
+const bool LoadLine(AvidaOrganismTable &organisms,
+                    const char * const begin,
+                    const char * const end,
+                    const bool isDetail) throw(int);
+void CheckIsAlive(const bool isAlive, const bool isDetail) throw(int);
+const unsigned int LoadedCount(const vector<iOrganism*> &organisms);
+const unsigned int LoadedCount(const AvidaOrganismTable &organisms);
+// Makes room for rows more organisms.
+void ReserveLoaded(vector<iOrganism*> &organisms, const unsigned int rows);
+void ReserveLoaded(AvidaOrganismTable &organisms, const unsigned int rows);
+// Moves the other organisms to the end of organisms.
+void AppendLoaded(vector<iOrganism*> &organisms,
+                  vector<iOrganism*> &other);
+void AppendLoaded(AvidaOrganismTable &organisms,
+                  AvidaOrganismTable &other);
+void DiscardLoaded(vector<iOrganism*> &organisms);
+void DiscardLoaded(AvidaOrganismTable &organisms);
+// Gives a chunk the same settings as the organisms it will be appended to.
+void PrepareChunk(vector<iOrganism*> &chunk,
+                  const vector<iOrganism*> &organisms);
+void PrepareChunk(AvidaOrganismTable &chunk,
+                  const AvidaOrganismTable &organisms);
+
+// Both return how many organism lines were read, which can be more than
+//   the number of organisms added when some are filtered out.
+template<class Organisms>
+const int LoadLines(Organisms &organisms,
+                    istream &in,
+                    const bool isDetail) throw(pair<int,int>);
+template<class Organisms>
+const int LoadLines(Organisms &organisms,
+                    const char * const begin,
+                    const char * const end,
+                    const bool isDetail) throw(pair<int,int>);
+template<class Organisms>
+void LoadChunks(Organisms &organisms,
+                const char * const begin,
+                const char * const end,
+                const bool isDetail,
+                ThreadPool &pool) throw(pair<int,int>);
+
+// A newline aligned piece of an input file and the results of parsing it.
+template<class Organisms>
+struct AvidaChunk
+{
+  const char *begin;
+  const char *end;
+  Organisms organisms;
+  int lines;
+  bool failed;
+  pair<int,int> error;
+};
+
+// Scanners used by Parse in place of stream extraction.  Each skips leading
+//   whitespace, reads one value in the same format operator>> accepts and
+//   moves pos just past it.  They never allocate and ignore the locale.
+//   False is returned, and pos is left alone, if no value could be read.
+inline const bool   IsSpace(const char c);
+inline const char  *SkipSpace(const char *pos, const char * const end);
+const bool          ScanInt(const char *&pos, const char * const end,
+                            int &value);
+const bool          ScanDouble(const char *&pos, const char * const end,
+                               double &value);
+// Moves pos past the next run of non-whitespace without converting it.
+const bool          SkipField(const char *&pos, const char * const end);
+// Converts the next field if convert is set, otherwise skips it.
+inline const bool   ScanField(const char *&pos, const char * const end,
+                              int &value, const bool convert);
+inline const bool   ScanField(const char *&pos, const char * const end,
+                              double &value, const bool convert);
+
 AvidaOrganism::AvidaOrganism(void)
 : id(-1),
   parentId(-1),
@@ -39,7 +126,8 @@ AvidaOrganism::AvidaOrganism(void)
   updateBorn(0),
   updateDeactivated(0),
   phyloDepth(-1),
-  genome(0)
+  genome(0),
+  ownsGenome(true)
 {
   return;
 }
@@ -57,7 +145,8 @@ AvidaOrganism::AvidaOrganism(const AvidaOrganism &data)
   updateBorn(0),
   updateDeactivated(0),
   phyloDepth(-1),
-  genome(0)
+  genome(0),
+  ownsGenome(true)
 {
   Assign(data);
   return;
@@ -65,7 +154,7 @@ AvidaOrganism::AvidaOrganism(const AvidaOrganism &data)
 
 AvidaOrganism::~AvidaOrganism(void)
 {
-  if(genome != 0)
+  if(genome != 0 && ownsGenome)
   {
     delete [] genome;
   }
@@ -158,12 +247,13 @@ const char * const AvidaOrganism::GetGenome(void) const
 
 void AvidaOrganism::Assign(const AvidaOrganism &data)
 {
-  if(genome != 0)
+  if(genome != 0 && ownsGenome)
   {
     delete [] genome;
   }
   genome = 0;
   genomeLength = 0;
+  ownsGenome = true;
 
   id                = data.id;
   parentId          = data.parentId;
@@ -196,137 +286,172 @@ void AvidaOrganism::Assign(const AvidaOrganism &data)
 
 AvidaOrganism* AvidaOrganism::Parse(const char * const data) throw(int)
 {
-  stringstream ss;
-  ss << data;
+  return Parse(data, data + strlen(data));
+}
 
-  ss >> ws;
+AvidaOrganism* AvidaOrganism::Parse(const char * const begin,
+                                    const char * const end) throw(int)
+{
+  AvidaOrganism od;
+  const char *genomeBegin = 0;
 
-  char c = static_cast<char>(ss.peek());
-  if(ss.eof() || c == '#')
+  if(!ParseFields(begin, end, AvidaOrganismTable::AllColumns, od,
+                  genomeBegin))
   {
     // do nothing if the line is blank or it is a comment
     return 0;
   }
 
+  AvidaOrganism *o = 0;
+  try
+  {
+    // od has no genome so the copy does not allocate one; the genome is
+    //   copied straight from the line instead, null terminated.
+    o = new AvidaOrganism(od);
+    if(od.genomeLength > 0)
+    {
+      o->genome = new char[od.genomeLength + 1];
+      memcpy(o->genome, genomeBegin, od.genomeLength);
+      o->genome[od.genomeLength] = '\0';
+      o->genomeLength = od.genomeLength;
+    }
+  }
+  catch(...)
+  {
+    if(o != 0)
+    {
+      delete o;
+      o = 0;
+    }
+    throw 14;
+  }
+
+  return o;
+}
+
+AvidaOrganism* AvidaOrganism::Parse(const char * const begin,
+                                    const char * const end,
+                                    Arena &arena) throw(int)
+{
   AvidaOrganism od;
+  const char *genomeBegin = 0;
 
-  ss >> od.id;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ParseFields(begin, end, AvidaOrganismTable::AllColumns, od,
+                  genomeBegin))
   {
-    throw 1;
+    // do nothing if the line is blank or it is a comment
+    return 0;
   }
 
-  ss >> od.parentId;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  AvidaOrganism *o = 0;
+  try
   {
-    throw 2;
+    o = new(arena.Allocate(sizeof(AvidaOrganism), alignof(AvidaOrganism)))
+      AvidaOrganism(od);
+    if(od.genomeLength > 0)
+    {
+      o->genome = arena.Copy(genomeBegin, genomeBegin + od.genomeLength);
+      o->genomeLength = od.genomeLength;
+      o->ownsGenome = false;
+    }
   }
-
-  ss >> od.parentDistance;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  catch(...)
   {
-    throw 3;
+    // Whatever was taken from the arena is freed along with the rest of it.
+    throw 14;
   }
 
-  ss >> od.currentAlive;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  return o;
+}
+
+const bool AvidaOrganism::ParseFields(const char * const begin,
+                                      const char * const end,
+                                      const unsigned int columns,
+                                      AvidaOrganism &od,
+                                      const char *&genome) throw(int)
+{
+  const char *pos = SkipSpace(begin, end);
+
+  if(pos == end || *pos == '#') { return false; }
+
+  // The genome is checked against its length so it needs that as well.
+  const bool withGenome = (columns & AvidaOrganismTable::GenomeColumn) != 0;
+  const bool withGenomeLength = withGenome ||
+    (columns & AvidaOrganismTable::GenomeLengthColumn) != 0;
+
+  // Each field must be read without error and, just as with the stream
+  //   extraction this replaces, must not end the line as the genome follows.
+  //   Current alive is always needed for the alive status.
+  if(!ScanInt(pos, end, od.id)                || pos == end) { throw 1;  }
+  if(!ScanInt(pos, end, od.parentId)          || pos == end) { throw 2;  }
+  if(!ScanField(pos, end, od.parentDistance,
+                (columns & AvidaOrganismTable::ParentDistanceColumn) != 0) ||
+     pos == end)
   {
-    throw 4;
+    throw 3;
   }
-
-  ss >> od.totalExisted;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ScanInt(pos, end, od.currentAlive)      || pos == end) { throw 4;  }
+  if(!ScanField(pos, end, od.totalExisted,
+                (columns & AvidaOrganismTable::TotalExistedColumn) != 0) ||
+     pos == end)
   {
     throw 5;
   }
-
-  ss >> od.genomeLength;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ScanField(pos, end, od.genomeLength, withGenomeLength) || pos == end)
   {
     throw 6;
   }
-
-  ss >> od.merit;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ScanField(pos, end, od.merit,
+                (columns & AvidaOrganismTable::MeritColumn) != 0) ||
+     pos == end)
   {
     throw 7;
   }
-
-  ss >> od.gestationTime;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ScanField(pos, end, od.gestationTime,
+                (columns & AvidaOrganismTable::GestationTimeColumn) != 0) ||
+     pos == end)
   {
     throw 8;
   }
-
-  ss >> od.fitness;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ScanField(pos, end, od.fitness,
+                (columns & AvidaOrganismTable::FitnessColumn) != 0) ||
+     pos == end)
   {
     throw 9;
   }
-
-  ss >> od.updateBorn;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
-  {
-    throw 10;
-  }
-
-  ss >> od.updateDeactivated;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ScanInt(pos, end, od.updateBorn)        || pos == end) { throw 10; }
+  if(!ScanField(pos, end, od.updateDeactivated,
+                (columns & AvidaOrganismTable::UpdateDeactivatedColumn) != 0) ||
+     pos == end)
   {
     throw 11;
   }
-
-  ss >> od.phyloDepth;
-  // Make sure there were no errors while reading in the data thus far
-  if(ss.fail() || ss.bad() || ss.eof())
+  if(!ScanField(pos, end, od.phyloDepth,
+                (columns & AvidaOrganismTable::PhyloDepthColumn) != 0) ||
+     pos == end)
   {
     throw 12;
   }
 
-  // Read in the genome
-  char genome[2048];
-  ss >> genome;
-
-  if(static_cast<int>(strlen(genome)) != od.genomeLength ||
-     ((ss.fail() || ss.bad()) && !ss.eof()))
+  // Without the genome there is no need to look at the rest of the line.
+  if(!withGenome)
   {
-    throw 13;
+    genome = 0;
+    return true;
   }
-  od.genome = genome;
 
-  AvidaOrganism *o = 0;
-  // In case I decide to put some error checking in the copy
-  try
-  {
-    o = new AvidaOrganism(od);
-  }
-  catch(...)
+  // Read in the genome, which is the next run of non-whitespace characters
+  const char *genomeBegin = SkipSpace(pos, end);
+  const char *genomeEnd = genomeBegin;
+  while(genomeEnd != end && !IsSpace(*genomeEnd)) { ++genomeEnd; }
+
+  if(static_cast<int>(genomeEnd - genomeBegin) != od.genomeLength)
   {
-    if(o != 0)
-    {
-      delete o;
-      o = 0;
-    }
-    od.genome = 0;
-    throw 14;
+    throw 13;
   }
+  genome = genomeBegin;
 
-  // Must set od.genome to zero because it is assigned a static 
-  //   array can should not be deleted in the destructor for od.
-  od.genome = 0;
-
-  return o;
+  return true;
 }
 
 const bool operator==(const AvidaOrganism &o1, const AvidaOrganism &o2)
@@ -350,46 +475,352 @@ const bool operator==(const AvidaOrganism &o1, const AvidaOrganism &o2)
   return false;
 }
 
+AvidaOrganismTable::AvidaOrganismTable(void)
+: columns(AllColumns)
+{
+  return;
+}
+
+AvidaOrganismTable::~AvidaOrganismTable(void)
+{
+  return;
+}
+
+void AvidaOrganismTable::SelectColumns(const unsigned int selected) throw(int)
+{
+  if(Size() != 0) { throw 1; }
+  columns = selected & AllColumns;
+  return;
+}
+
+void AvidaOrganismTable::SetRowFilter(const RowFilter &filter) throw(int)
+{
+  if(Size() != 0) { throw 1; }
+  rowFilter = filter;
+  return;
+}
+
+const unsigned int AvidaOrganismTable::GetColumns(void) const
+{
+  return columns;
+}
+
+const AvidaOrganismTable::RowFilter &
+AvidaOrganismTable::GetRowFilter(void) const
+{
+  return rowFilter;
+}
+
+const bool AvidaOrganismTable::Parse(const char * const begin,
+                                     const char * const end) throw(int)
+{
+  AvidaOrganism od;
+  const char *genome = 0;
+
+  if(!AvidaOrganism::ParseFields(begin, end, columns, od, genome))
+  {
+    return false;
+  }
+
+  // Filtered records are still organism lines, so they are reported as read.
+  if(rowFilter && !rowFilter(od)) { return true; }
+
+  OrganismTable::Append(od.id, od.parentId, od.updateBorn,
+                        od.currentAlive > 0);
+  if(columns & ParentDistanceColumn)
+    parentDistances.push_back(od.parentDistance);
+  if(columns & CurrentAliveColumn)
+    currentAlive.push_back(od.currentAlive);
+  if(columns & TotalExistedColumn)
+    totalExisted.push_back(od.totalExisted);
+  if(columns & GenomeLengthColumn)
+    genomeLengths.push_back(od.genomeLength);
+  if(columns & MeritColumn)
+    merits.push_back(od.merit);
+  if(columns & GestationTimeColumn)
+    gestationTimes.push_back(od.gestationTime);
+  if(columns & FitnessColumn)
+    fitnesses.push_back(od.fitness);
+  if(columns & UpdateDeactivatedColumn)
+    updateDeactivated.push_back(od.updateDeactivated);
+  if(columns & PhyloDepthColumn)
+    phyloDepths.push_back(od.phyloDepth);
+
+  // Genomes are stored null terminated so GetGenome can return them as is.
+  if(columns & GenomeColumn)
+  {
+    genomes.push_back(genomeArena.Copy(genome, genome + od.genomeLength));
+  }
+
+  return true;
+}
+
+void AvidaOrganismTable::Append(const AvidaOrganismTable &other)
+{
+  AppendColumns(other);
+
+  vector<const char*>::const_iterator i = other.genomes.begin();
+  for(; i != other.genomes.end(); ++i)
+  {
+    genomes.push_back(genomeArena.Copy(*i, *i + strlen(*i)));
+  }
+
+  return;
+}
+
+void AvidaOrganismTable::Take(AvidaOrganismTable &other)
+{
+  if(&other == this) { return; }
+
+  // The genomes stay where they are, now owned by this table's arena.
+  AppendColumns(other);
+  genomes.insert(genomes.end(), other.genomes.begin(), other.genomes.end());
+  genomeArena.Adopt(other.genomeArena);
+  other.Clear();
+
+  return;
+}
+
+void AvidaOrganismTable::AppendColumns(const AvidaOrganismTable &other)
+{
+  OrganismTable::Append(other);
+  parentDistances.insert(parentDistances.end(), other.parentDistances.begin(),
+                         other.parentDistances.end());
+  currentAlive.insert(currentAlive.end(), other.currentAlive.begin(),
+                      other.currentAlive.end());
+  totalExisted.insert(totalExisted.end(), other.totalExisted.begin(),
+                      other.totalExisted.end());
+  genomeLengths.insert(genomeLengths.end(), other.genomeLengths.begin(),
+                       other.genomeLengths.end());
+  merits.insert(merits.end(), other.merits.begin(), other.merits.end());
+  gestationTimes.insert(gestationTimes.end(), other.gestationTimes.begin(),
+                        other.gestationTimes.end());
+  fitnesses.insert(fitnesses.end(), other.fitnesses.begin(),
+                   other.fitnesses.end());
+  updateDeactivated.insert(updateDeactivated.end(),
+                           other.updateDeactivated.begin(),
+                           other.updateDeactivated.end());
+  phyloDepths.insert(phyloDepths.end(), other.phyloDepths.begin(),
+                     other.phyloDepths.end());
+
+  return;
+}
+
+void AvidaOrganismTable::Clear(void)
+{
+  OrganismTable::Clear();
+
+  // swap with empty vectors to release the memory as well
+  vector<int>().swap(parentDistances);
+  vector<int>().swap(currentAlive);
+  vector<int>().swap(totalExisted);
+  vector<int>().swap(genomeLengths);
+  vector<double>().swap(merits);
+  vector<double>().swap(gestationTimes);
+  vector<double>().swap(fitnesses);
+  vector<int>().swap(updateDeactivated);
+  vector<int>().swap(phyloDepths);
+  vector<const char*>().swap(genomes);
+  genomeArena.Clear();
+
+  return;
+}
+
+void AvidaOrganismTable::Reserve(const unsigned int size)
+{
+  OrganismTable::Reserve(size);
+  if(columns & ParentDistanceColumn)    parentDistances.reserve(size);
+  if(columns & CurrentAliveColumn)      currentAlive.reserve(size);
+  if(columns & TotalExistedColumn)      totalExisted.reserve(size);
+  if(columns & GenomeLengthColumn)      genomeLengths.reserve(size);
+  if(columns & MeritColumn)             merits.reserve(size);
+  if(columns & GestationTimeColumn)     gestationTimes.reserve(size);
+  if(columns & FitnessColumn)           fitnesses.reserve(size);
+  if(columns & UpdateDeactivatedColumn) updateDeactivated.reserve(size);
+  if(columns & PhyloDepthColumn)        phyloDepths.reserve(size);
+  if(columns & GenomeColumn)            genomes.reserve(size);
+
+  return;
+}
+
+const int AvidaOrganismTable::GetParentDistance(const unsigned int i) const
+{
+  return parentDistances[i];
+}
+
+const int AvidaOrganismTable::GetCurrentAlive(const unsigned int i) const
+{
+  return currentAlive[i];
+}
+
+const int AvidaOrganismTable::GetTotalExisted(const unsigned int i) const
+{
+  return totalExisted[i];
+}
+
+const int AvidaOrganismTable::GetGenomeLength(const unsigned int i) const
+{
+  return genomeLengths[i];
+}
+
+const double AvidaOrganismTable::GetMerit(const unsigned int i) const
+{
+  return merits[i];
+}
+
+const double AvidaOrganismTable::GetGestationTime(const unsigned int i) const
+{
+  return gestationTimes[i];
+}
+
+const double AvidaOrganismTable::GetFitness(const unsigned int i) const
+{
+  return fitnesses[i];
+}
+
+const int AvidaOrganismTable::GetUpdateBorn(const unsigned int i) const
+{
+  return static_cast<int>(GetBirthTime(i));
+}
+
+const int AvidaOrganismTable::GetUpdateDeactivated(const unsigned int i) const
+{
+  return updateDeactivated[i];
+}
+
+const int AvidaOrganismTable::GetPhyloDepth(const unsigned int i) const
+{
+  return phyloDepths[i];
+}
+
+const char *AvidaOrganismTable::GetGenome(const unsigned int i) const
+{
+  return genomes[i];
+}
+
 void LoadAvidaOrganisms(vector<iOrganism*> &organisms,
                         istream &in,
                         const bool isDetail) throw(pair<int,int>)
 {
-  char line[2048];
+  LoadLines(organisms, in, isDetail);
+  return;
+}
 
-  // read in each line, and start counting line numbers at 1
-  int i = 1;
-  while(!in.eof())
-  {
-    // set line to the empty string
-    line[0] = '\0';
+void LoadAvidaOrganisms(vector<iOrganism*> &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail) throw(pair<int,int>)
+{
+  LoadLines(organisms, begin, end, isDetail);
+  return;
+}
+
+void LoadAvidaOrganisms(vector<iOrganism*> &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail,
+                        ThreadPool &pool) throw(pair<int,int>)
+{
+  LoadChunks(organisms, begin, end, isDetail, pool);
+  return;
+}
+
+void LoadAvidaOrganisms(AvidaOrganismTable &organisms,
+                        istream &in,
+                        const bool isDetail) throw(pair<int,int>)
+{
+  LoadLines(organisms, in, isDetail);
+  return;
+}
+
+void LoadAvidaOrganisms(AvidaOrganismTable &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail) throw(pair<int,int>)
+{
+  LoadLines(organisms, begin, end, isDetail);
+  return;
+}
 
-    // read in a line from the file
-    in.getline(line, 2047);
+void LoadAvidaOrganisms(AvidaOrganismTable &organisms,
+                        const char * const begin,
+                        const char * const end,
+                        const bool isDetail,
+                        ThreadPool &pool) throw(pair<int,int>)
+{
+  LoadChunks(organisms, begin, end, isDetail, pool);
+  return;
+}
 
-    // create a new organism from the line using the Parse function
+template<class Organisms>
+const int LoadLines(Organisms &organisms,
+                    istream &in,
+                    const bool isDetail) throw(pair<int,int>)
+{
+  string line;
+
+  // read in each line, however long, and start counting line numbers at 1
+  int i = 1;
+  while(getline(in, line))
+  {
     try
     {
-      // Not all lines are organisms so a return of zero indicates that
+      // Not all lines are organisms so a return of false indicates that
       //   a valid organism was not loaded so skip.
-      iOrganism *od = AvidaOrganism::Parse(line);
+      if(!LoadLine(organisms, line.data(), line.data() + line.size(),
+                   isDetail))
+      {
+        continue;
+      }
+    }
+    catch(int x)
+    {
+      throw make_pair(i, x);
+    }
 
-      // It will only be zero for comments and blank lines, otherwise it
-      //   throws and exception upon error.
-      if(od == 0) { continue; }
+    ++i;
+  }
 
-      // Insert first so if an error follows it will be deleted when
-      //   the calling function cleans up the organism vector.
-      organisms.push_back(od);
+  return i - 1;
+}
 
-      // Make sure that only those who are alive are in the detail file.
-      if(isDetail == false && od->GetIsAlive() == true)
-      {
-        throw -1;
-      }
-      // Make sure that those in the detail file are not dead.
-      else if(isDetail == true && od->GetIsAlive() == false)
+template<class Organisms>
+const int LoadLines(Organisms &organisms,
+                    const char * const begin,
+                    const char * const end,
+                    const bool isDetail) throw(pair<int,int>)
+{
+  // Every organism is on its own line so the number of lines bounds how
+  //   many will be added, which saves growing the storage while loading.
+  unsigned int lines = 0;
+  const char *newline = begin;
+  while((newline = static_cast<const char *>(
+           memchr(newline, '\n', static_cast<size_t>(end - newline)))) != 0)
+  {
+    ++lines;
+    ++newline;
+  }
+  ReserveLoaded(organisms, lines + 1);
+
+  // Line numbers are counted the same way as the stream version so that
+  //   errors are reported identically for both.
+  int i = 1;
+  const char *lineBegin = begin;
+  while(lineBegin < end)
+  {
+    // find the end of the current line, without the newline
+    const char *lineEnd = static_cast<const char *>(
+      memchr(lineBegin, '\n', static_cast<size_t>(end - lineBegin)));
+    if(lineEnd == 0) { lineEnd = end; }
+
+    const char *next = lineEnd + 1;
+
+    try
+    {
+      if(!LoadLine(organisms, lineBegin, lineEnd, isDetail))
       {
-        throw -2;
+        lineBegin = next;
+        continue;
       }
     }
     catch(int x)
@@ -397,9 +828,220 @@ void LoadAvidaOrganisms(vector<iOrganism*> &organisms,
       throw make_pair(i, x);
     }
 
+    lineBegin = next;
     ++i;
   }
 
+  return i - 1;
+}
+
+template<class Organisms>
+void LoadChunks(Organisms &organisms,
+                const char * const begin,
+                const char * const end,
+                const bool isDetail,
+                ThreadPool &pool) throw(pair<int,int>)
+{
+  // Several chunks per thread keeps the threads busy when lines are not
+  //   evenly spread, but small inputs are not worth splitting up.
+  const size_t minimumChunkSize = 1 << 20;
+  const size_t size = static_cast<size_t>(end - begin);
+  size_t chunkCount = pool.Size() * 4;
+  if(size / minimumChunkSize < chunkCount)
+  {
+    chunkCount = size / minimumChunkSize;
+  }
+  if(pool.Size() <= 1 || chunkCount <= 1)
+  {
+    LoadLines(organisms, begin, end, isDetail);
+    return;
+  }
+
+  // Cut the input into roughly equal chunks, moving each cut to just past
+  //   the next newline so that every line is entirely within one chunk.
+  vector<AvidaChunk<Organisms> > chunks(chunkCount);
+  const char *chunkBegin = begin;
+  for(size_t c = 0; c < chunkCount; ++c)
+  {
+    const char *chunkEnd = end;
+    if(c + 1 < chunkCount)
+    {
+      chunkEnd = begin + size / chunkCount * (c + 1);
+      if(chunkEnd < chunkBegin) { chunkEnd = chunkBegin; }
+      const char *newline = static_cast<const char *>(
+        memchr(chunkEnd, '\n', static_cast<size_t>(end - chunkEnd)));
+      chunkEnd = (newline == 0) ? end : newline + 1;
+    }
+
+    chunks[c].begin = chunkBegin;
+    chunks[c].end = chunkEnd;
+    chunks[c].lines = 0;
+    chunks[c].failed = false;
+    PrepareChunk(chunks[c].organisms, organisms);
+    chunkBegin = chunkEnd;
+  }
+
+  pool.Run(static_cast<unsigned int>(chunkCount), [&](unsigned int c)
+  {
+    try
+    {
+      chunks[c].lines = LoadLines(chunks[c].organisms, chunks[c].begin,
+                                  chunks[c].end, isDetail);
+    }
+    catch(pair<int,int> errorData)
+    {
+      chunks[c].failed = true;
+      chunks[c].error = errorData;
+    }
+  });
+
+  // Only the chunks up to and including the first failure are kept.
+  unsigned int rows = 0;
+  typename vector<AvidaChunk<Organisms> >::iterator i = chunks.begin();
+  for(; i != chunks.end(); ++i)
+  {
+    rows += LoadedCount(i->organisms);
+    if(i->failed) { break; }
+  }
+  ReserveLoaded(organisms, rows);
+
+  // Append the chunks in file order.  The organism lines in the earlier
+  //   chunks give the offset of a chunk's line numbers.  Chunks after the
+  //   first failure are discarded just as the serial loader would never have
+  //   read them.
+  int linesBefore = 0;
+  for(i = chunks.begin(); i != chunks.end() && !i->failed; ++i)
+  {
+    AppendLoaded(organisms, i->organisms);
+    linesBefore += i->lines;
+  }
+
+  if(i == chunks.end()) { return; }
+
+  AppendLoaded(organisms, i->organisms);
+  const pair<int,int> errorData(linesBefore + i->error.first,
+                                i->error.second);
+
+  for(++i; i != chunks.end(); ++i)
+  {
+    DiscardLoaded(i->organisms);
+  }
+
+  throw errorData;
+}
+
+const bool LoadLine(vector<iOrganism*> &organisms,
+                    const char * const begin,
+                    const char * const end,
+                    const bool isDetail) throw(int)
+{
+  // It will only be zero for comments and blank lines, otherwise Parse
+  //   throws and exception upon error.
+  iOrganism *od = AvidaOrganism::Parse(begin, end);
+  if(od == 0) { return false; }
+
+  // Insert first so if an error follows it will be deleted when
+  //   the calling function cleans up the organism vector.
+  organisms.push_back(od);
+  CheckIsAlive(od->GetIsAlive(), isDetail);
+
+  return true;
+}
+
+const bool LoadLine(AvidaOrganismTable &organisms,
+                    const char * const begin,
+                    const char * const end,
+                    const bool isDetail) throw(int)
+{
+  const unsigned int size = organisms.Size();
+  if(!organisms.Parse(begin, end)) { return false; }
+
+  // Nothing is added for records the row filter rejects.
+  if(organisms.Size() != size)
+  {
+    CheckIsAlive(organisms.GetIsAlive(size), isDetail);
+  }
+
+  return true;
+}
+
+void CheckIsAlive(const bool isAlive, const bool isDetail) throw(int)
+{
+  // Make sure that only those who are alive are in the detail file.
+  if(isDetail == false && isAlive == true)
+  {
+    throw -1;
+  }
+  // Make sure that those in the detail file are not dead.
+  else if(isDetail == true && isAlive == false)
+  {
+    throw -2;
+  }
+
+  return;
+}
+
+const unsigned int LoadedCount(const vector<iOrganism*> &organisms)
+{
+  return static_cast<unsigned int>(organisms.size());
+}
+
+const unsigned int LoadedCount(const AvidaOrganismTable &organisms)
+{
+  return organisms.Size();
+}
+
+void ReserveLoaded(vector<iOrganism*> &organisms, const unsigned int rows)
+{
+  organisms.reserve(organisms.size() + rows);
+  return;
+}
+
+void ReserveLoaded(AvidaOrganismTable &organisms, const unsigned int rows)
+{
+  organisms.Reserve(organisms.Size() + rows);
+  return;
+}
+
+void AppendLoaded(vector<iOrganism*> &organisms,
+                  vector<iOrganism*> &other)
+{
+  organisms.insert(organisms.end(), other.begin(), other.end());
+  other.clear();
+  return;
+}
+
+void AppendLoaded(AvidaOrganismTable &organisms,
+                  AvidaOrganismTable &other)
+{
+  organisms.Take(other);
+  return;
+}
+
+void DiscardLoaded(vector<iOrganism*> &organisms)
+{
+  vector<iOrganism*>::iterator i = organisms.begin();
+  for(; i != organisms.end(); ++i) { delete *i; }
+  organisms.clear();
+  return;
+}
+
+void DiscardLoaded(AvidaOrganismTable &organisms)
+{
+  organisms.Clear();
+  return;
+}
+
+void PrepareChunk(vector<iOrganism*> &, const vector<iOrganism*> &)
+{
+  return;
+}
+
+void PrepareChunk(AvidaOrganismTable &chunk,
+                  const AvidaOrganismTable &organisms)
+{
+  chunk.SelectColumns(organisms.GetColumns());
+  chunk.SetRowFilter(organisms.GetRowFilter());
   return;
 }
 
@@ -432,3 +1074,193 @@ set<int> CheckForDuplicateIds(const vector<iOrganism*> &organisms) throw(int)
 
   return duplicates;
 }
+
+set<int> CheckForDuplicateIds(const OrganismTable &organisms)
+{
+  set<int> ids;
+  set<int> duplicates;
+
+  for(unsigned int i = 0; i < organisms.Size(); ++i)
+  {
+    if(!ids.insert(organisms.GetId(i)).second)
+    {
+      duplicates.insert(organisms.GetId(i));
+    }
+  }
+
+  return duplicates;
+}
+
+inline const bool IsSpace(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+         c == '\v' || c == '\f';
+}
+
+inline const char *SkipSpace(const char *pos, const char * const end)
+{
+  while(pos != end && IsSpace(*pos)) { ++pos; }
+  return pos;
+}
+
+const bool ScanInt(const char *&pos, const char * const end, int &value)
+{
+  const char *p = SkipSpace(pos, end);
+
+  bool negative = false;
+  if(p != end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  // Accumulate the magnitude, failing on overflow just as operator>> does.
+  const unsigned int limit = (negative)
+    ? static_cast<unsigned int>(INT_MAX) + 1
+    : static_cast<unsigned int>(INT_MAX);
+  const char *digits = p;
+  unsigned int magnitude = 0;
+  for(; p != end && *p >= '0' && *p <= '9'; ++p)
+  {
+    const unsigned int digit = static_cast<unsigned int>(*p - '0');
+    if(magnitude > (limit - digit) / 10) { return false; }
+    magnitude = magnitude * 10 + digit;
+  }
+  if(p == digits) { return false; }
+
+  if(negative && magnitude > 0)
+  {
+    // Written this way so that INT_MIN does not overflow
+    value = -static_cast<int>(magnitude - 1) - 1;
+  }
+  else
+  {
+    value = static_cast<int>(magnitude);
+  }
+  pos = p;
+
+  return true;
+}
+
+const bool SkipField(const char *&pos, const char * const end)
+{
+  const char *p = SkipSpace(pos, end);
+  const char *field = p;
+  while(p != end && !IsSpace(*p)) { ++p; }
+  if(p == field) { return false; }
+  pos = p;
+
+  return true;
+}
+
+inline const bool ScanField(const char *&pos, const char * const end,
+                            int &value, const bool convert)
+{
+  return (convert) ? ScanInt(pos, end, value) : SkipField(pos, end);
+}
+
+inline const bool ScanField(const char *&pos, const char * const end,
+                            double &value, const bool convert)
+{
+  return (convert) ? ScanDouble(pos, end, value) : SkipField(pos, end);
+}
+
+const bool ScanDouble(const char *&pos, const char * const end, double &value)
+{
+  // Powers of ten that are exactly representable as a double.
+  static const double powersOfTen[] =
+  {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  const char *start = SkipSpace(pos, end);
+  const char *p = start;
+
+  bool negative = false;
+  if(p != end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  // Read the mantissa as an integer and the power of ten it must be scaled
+  //   by.  Up to 15 significant digits are held exactly.
+  double mantissa = 0;
+  int significant = 0;
+  int exponent = 0;
+  bool anyDigits = false;
+  for(; p != end && *p >= '0' && *p <= '9'; ++p)
+  {
+    anyDigits = true;
+    if(mantissa == 0 && *p == '0') { continue; }
+    if(significant < 15) { mantissa = mantissa * 10 + (*p - '0'); }
+    else                 { ++exponent; }
+    ++significant;
+  }
+  if(p != end && *p == '.')
+  {
+    for(++p; p != end && *p >= '0' && *p <= '9'; ++p)
+    {
+      anyDigits = true;
+      if(mantissa == 0 && *p == '0') { --exponent; continue; }
+      if(significant < 15)
+      {
+        mantissa = mantissa * 10 + (*p - '0');
+        --exponent;
+      }
+      ++significant;
+    }
+  }
+  if(!anyDigits) { return false; }
+
+  if(p != end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negativeExponent = false;
+    if(p != end && (*p == '-' || *p == '+'))
+    {
+      negativeExponent = (*p == '-');
+      ++p;
+    }
+
+    // Large exponents are clamped; the result is out of range either way.
+    const char *digits = p;
+    int exponentValue = 0;
+    for(; p != end && *p >= '0' && *p <= '9'; ++p)
+    {
+      if(exponentValue < 100000)
+      {
+        exponentValue = exponentValue * 10 + (*p - '0');
+      }
+    }
+    if(p == digits) { return false; }
+
+    exponent += (negativeExponent) ? -exponentValue : exponentValue;
+  }
+
+  if(significant <= 15 && exponent >= -22 && exponent <= 22)
+  {
+    // Both values are exact, so a single multiply or divide gives the
+    //   correctly rounded result.
+    value = (exponent < 0) ? mantissa / powersOfTen[-exponent]
+                           : mantissa * powersOfTen[exponent];
+    if(negative) { value = -value; }
+  }
+  else
+  {
+    // Rare: too many digits or too large an exponent to convert exactly
+    //   here, so let the C library round it.
+    const string token(start, p);
+    char *tokenEnd = 0;
+    value = strtod(token.c_str(), &tokenEnd);
+    if(tokenEnd != token.c_str() + token.size() ||
+       value == HUGE_VAL || value == -HUGE_VAL)
+    {
+      return false;
+    }
+  }
+  pos = p;
+
+  return true;
+}
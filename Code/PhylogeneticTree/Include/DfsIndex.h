@@ -0,0 +1,89 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __PhylogeneticTree_Include_DfsIndex_h__
+#define __PhylogeneticTree_Include_DfsIndex_h__
+
+#include <atomic>
+#include <vector>
+
+namespace PhylogeneticTree
+{
+  class TreeNode;
+
+  // DfsIndex numbers the nodes of a tree in preorder, each parent before
+  //   its children, so the subtree of a node takes up the positions from
+  //   Enter to Exit of that node.  Counting the leaves of a subtree is a
+  //   difference of two prefix sums.
+  class DfsIndex
+  {
+  private:
+    // By slot.
+    std::vector<unsigned int> enter;
+    std::vector<unsigned int> exit;
+    // By position.
+    std::vector<TreeNode*>    nodes;
+    std::vector<int>          depths;
+    // leafPrefix[p] is the number of leaves before position p.
+    std::vector<unsigned int> leafPrefix;
+    // Set last by Build, so a reader that sees it set sees the whole index.
+    std::atomic<bool>         built;
+
+  public:
+    DfsIndex(void);
+    ~DfsIndex(void);
+
+    // Throws 0 if a node's slot is not below slots or the tree has a cycle.
+    void Build(TreeNode *root, const unsigned int slots) throw(int);
+    // Keeps the memory for the next Build.
+    void Invalidate(void) { built = false; }
+    const bool IsBuilt(void) const { return built; }
+
+    const unsigned int Enter(const unsigned int slot) const
+    {
+      return enter[slot];
+    }
+    const unsigned int Exit(const unsigned int slot) const
+    {
+      return exit[slot];
+    }
+    const unsigned int HowManyLeaves(const unsigned int slot) const
+    {
+      return leafPrefix[exit[slot]] - leafPrefix[enter[slot]];
+    }
+
+    const unsigned int Size(void) const
+    {
+      return static_cast<unsigned int>(nodes.size());
+    }
+    TreeNode *GetNode(const unsigned int position)  const
+    {
+      return nodes[position];
+    }
+    const int GetDepth(const unsigned int position) const
+    {
+      return depths[position];
+    }
+
+  private:
+    DfsIndex(const DfsIndex &);
+    const DfsIndex &operator=(const DfsIndex &);
+  };
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Include_DfsIndex_h__
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PhylogeneticTree_Include_NodePool_h__
+#define __PhylogeneticTree_Include_NodePool_h__
+
+#include <cstddef>
+#include <vector>
+
+#include "Support/Interface/Arena.h"
+
+namespace PhylogeneticTree
+{
+  class iOrganism;
+  class OrganismTable;
+  class TreeNode;
+
+  // NodePool owns the memory of a tree's nodes and of their lists of
+  //   children.  Both are carved out of large arena blocks, so a tree of a
+  //   million nodes is a few hundred blocks rather than two million small
+  //   heap allocations, and Clear releases all of it at once without
+  //   visiting any node.
+  //
+  // Destroyed nodes and the child lists a node outgrows are kept on free
+  //   lists and handed out again.  Child lists are kept by size in powers
+  //   of two, which is how std::vector grows them.
+  class NodePool
+  {
+  private:
+    struct FreeBlock
+    {
+      FreeBlock *next;
+    };
+
+    Arena                   arena;
+    FreeBlock              *freeNodes;
+    // freeLists[k] holds released blocks of MinimumBlock << k bytes.
+    std::vector<FreeBlock*> freeLists;
+    std::size_t             liveNodes;
+
+    static const std::size_t MinimumBlock = sizeof(FreeBlock);
+
+  public:
+    NodePool(void);
+    ~NodePool(void);
+
+    // Throws 1 if the memory for the node can not be allocated or the
+    //   node can not be made; the memory is kept for the next Create.
+    TreeNode *Create(const iOrganism &) throw(int);
+    // A node reading its fields from a row of the table.
+    TreeNode *Create(const OrganismTable &, const unsigned int row) throw(int);
+    // A node for the same organism as the other, which may be from another
+    //   pool, taking its fields from the node rather than the organism.
+    TreeNode *Create(const TreeNode &) throw(int);
+    // Runs the destructor and keeps the memory for the next Create.
+    void      Destroy(TreeNode *);
+
+    void     *Allocate(const std::size_t size);
+    void      Deallocate(void *memory, const std::size_t size);
+
+    // Releases every node and child list without running any destructors;
+    //   every node created by the pool is invalid afterwards.
+    void      Clear(void);
+    // The same as Clear, but the memory is kept for the nodes and child
+    //   lists of the next tree rather than given back.
+    void      Reset(void);
+
+    // Nodes created and not yet destroyed.
+    const std::size_t Size(void) const { return liveNodes; }
+
+  private:
+    void *NewNode(void) throw(int);
+    // Takes back the memory of a node that was destroyed, or never made.
+    void  FreeNode(void *memory);
+    static const std::size_t SizeClass(const std::size_t size);
+
+    NodePool(const NodePool &);
+    const NodePool &operator=(const NodePool &);
+  };
+
+  // Allocator for containers whose memory should come from a NodePool.
+  template <class T>
+  class PoolAllocator
+  {
+  public:
+    typedef T value_type;
+
+    NodePool *pool;
+
+    explicit PoolAllocator(NodePool &p) : pool(&p) {}
+    template <class U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool(other.pool) {}
+
+    T *allocate(const std::size_t n)
+    {
+      return static_cast<T*>(pool->Allocate(n * sizeof(T)));
+    }
+    void deallocate(T *p, const std::size_t n)
+    {
+      pool->Deallocate(p, n * sizeof(T));
+      return;
+    }
+  };
+
+  template <class T, class U>
+  bool operator==(const PoolAllocator<T> &a, const PoolAllocator<U> &b)
+  {
+    return a.pool == b.pool;
+  }
+
+  template <class T, class U>
+  bool operator!=(const PoolAllocator<T> &a, const PoolAllocator<U> &b)
+  {
+    return a.pool != b.pool;
+  }
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Include_NodePool_h__
@@ -19,42 +19,93 @@
 
 #include <vector>
 
+#include "PhylogeneticTree/Include/NodePool.h"
+#include "PhylogeneticTree/Interface/iOrganism.h"
 #include "PhylogeneticTree/Interface/iTreeNode.h"
 
 namespace PhylogeneticTree
 {
-  class iOrganism;
+  class OrganismTable;
 
-  class TreeNode : public iTreeNode
+  // The iOrganism of a TreeNode made from a table row.  The node keeps
+  //   every field of the row, so it answers for the row itself.
+  class RowOrganism : public iOrganism
   {
+  public:
+    const int    GetId(void)        const;
+    const int    GetParentId(void)  const;
+    const double GetBirthTime(void) const;
+    const bool   GetIsAlive(void)   const;
+  };
+
+  // TreeNodes are made and destroyed by the NodePool of their tree, which
+  //   also holds their lists of children.
+  //
+  // RowOrganism is the first base so the node's own fields can fill the
+  //   padding after iTreeNode's, which keeps the node at 96 bytes.
+  class TreeNode : private RowOrganism, public iTreeNode
+  {
+  public:
+    typedef std::vector<TreeNode*, PoolAllocator<TreeNode*> > ChildList;
+
   private:
-    iOrganism &data;
-    TreeNode *parent;
-    std::vector<TreeNode*> children;
     bool deleteMe;
+    // Position of the node in its tree's list of nodes.
+    unsigned int slot;
+    // The organism the node was made from, or the node itself if it was
+    //   made from a table row.
+    const iOrganism *organism;
+    TreeNode *parent;
+    ChildList children;
+    // Position of the node in its parent's list of children, kept up to
+    //   date by the parent so siblings are found without a search.
+    unsigned int childIndex;
+    // Position of the node in its tree's list of leaves, if it is a leaf.
+    unsigned int leafIndex;
 
   public:
-    TreeNode(const iOrganism &);
-    ~TreeNode(void);
-
     // Available through iTreeNode
     const iOrganism   &GetData(void)         const;
     const unsigned int HowManyChildren(void) const;
+    using iTreeNode::GetBirthTime;
+    using iTreeNode::GetId;
+    using iTreeNode::GetIsAlive;
+    using iTreeNode::GetParentId;
 
     // Hidden through iTreeNode as this header is not intended to be 
     //   available outside this package.
     void                          ChangeChild(const TreeNode &from,
                                               const TreeNode &to);
-    const std::vector<TreeNode*> &GetChildren(void)             const;
+    const unsigned int            GetChildIndex(void)           const;
+    const ChildList              &GetChildren(void)             const;
     const bool                    GetDeleteMe(void)             const;
+    const unsigned int            GetLeafIndex(void)            const;
     TreeNode*                     GetParent(void)               const;
+    const unsigned int            GetSlot(void)                 const;
     void                          InsertChild(const TreeNode &) throw(int);
     void                          RemoveChild(const TreeNode &);
+    void                          ReserveChildren(const unsigned int);
     void                          SetAsRoot(void);
     void                          SetDeleteMe(const bool);
+    void                          SetIsAlive(const bool);
+    void                          SetLeafIndex(const unsigned int);
     void                          SetParent(const TreeNode &);
+    void                          SetSlot(const unsigned int);
 
   private:
+    friend class NodePool;
+    friend class RowOrganism;
+
+    TreeNode(const iOrganism &, NodePool &);
+    TreeNode(const OrganismTable &, const unsigned int row, NodePool &);
+    // Same organism and fields as the other node, but no links.
+    TreeNode(const TreeNode &, NodePool &);
+    ~TreeNode(void);
+
+    // Position of the node in children, or the number of children if it
+    //   is not one of them.
+    const std::size_t FindChild(const TreeNode &) const;
+
     TreeNode(const TreeNode &);
     const TreeNode &operator=(const TreeNode &);
   };
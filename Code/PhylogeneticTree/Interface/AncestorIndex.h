@@ -0,0 +1,86 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __PhylogeneticTree_Interface_AncestorIndex_h__
+#define __PhylogeneticTree_Interface_AncestorIndex_h__
+
+#include <vector>
+
+#include "PhylogeneticTree/Interface/TreeIterator.h"
+
+namespace PhylogeneticTree
+{
+  class Tree;
+
+  // AncestorIndex finds the most recent common ancestor of two nodes in
+  //   constant time.  Two nodes at preorder positions a < b (see
+  //   Tree::GetInterval) meet at the parent of the shallowest node among
+  //   the positions a+1..b, so a query is a range minimum over depths.
+  //   The minimums of runs of whole blocks are kept in a sparse table, and
+  //   the partial blocks at either end are scanned, which keeps the memory
+  //   close to that of the depths themselves.
+  //
+  // The index reads the tree's positions when it is made, so make it
+  //   again after the tree changes.
+  class AncestorIndex
+  {
+  private:
+    const Tree &tree;
+    // By position.
+    std::vector<int>          depths;
+    std::vector<unsigned int> parents;
+    // blockMinimums[k][j] is the position of the shallowest node in the
+    //   2^k blocks starting at block j.
+    std::vector<std::vector<unsigned int> > blockMinimums;
+
+  public:
+    explicit AncestorIndex(const Tree &) throw(int);
+    ~AncestorIndex(void);
+
+    // These throw 0 for End or a deleted node.
+    TreeIterator FindCommonAncestor(const TreeIterator &,
+                                    const TreeIterator &) const throw(int);
+    // The common ancestor of all the nodes; End if there are none.
+    TreeIterator FindCommonAncestor(const std::vector<TreeIterator> &) const
+                   throw(int);
+    // The same by preorder position; throws 0 past the last position.
+    const unsigned int FindCommonAncestor(const unsigned int,
+                                          const unsigned int) const
+                         throw(int);
+    // Number of branches on the path between the two nodes.
+    const int    Distance(const TreeIterator &,
+                          const TreeIterator &) const throw(int);
+    // Sum of the birth time differences along that path, the time from
+    //   each node back to their common ancestor.
+    const double TimeDistance(const TreeIterator &,
+                              const TreeIterator &) const throw(int);
+
+  private:
+    const unsigned int CommonAncestor(const unsigned int,
+                                      const unsigned int) const;
+    const unsigned int Shallower(const unsigned int,
+                                 const unsigned int) const;
+    const unsigned int Shallowest(const unsigned int first,
+                                  const unsigned int last) const;
+
+    AncestorIndex(const AncestorIndex &);
+    const AncestorIndex &operator=(const AncestorIndex &);
+  };
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_AncestorIndex_h__
@@ -23,6 +23,7 @@ class OutputStream;
 
 namespace PhylogeneticTree
 {
+  class FlatTree;
   class Tree;
 
   double ComputeBalance(const Tree &,
@@ -32,6 +33,13 @@ namespace PhylogeneticTree
                         std::ostream &reportCsv,
                         std::ostream &listTxt,
                         std::ostream &listCsv) throw(int);
+  double ComputeBalance(const FlatTree &,
+                        OutputStream &output,
+                        const bool generateReport,
+                        std::ostream &reportTxt,
+                        std::ostream &reportCsv,
+                        std::ostream &listTxt,
+                        std::ostream &listCsv) throw(int);
 
 } // namespace PhylogeneticTree
 
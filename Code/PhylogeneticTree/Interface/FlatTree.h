@@ -0,0 +1,97 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PhylogeneticTree_Interface_FlatTree_h__
+#define __PhylogeneticTree_Interface_FlatTree_h__
+
+#include <vector>
+
+namespace PhylogeneticTree
+{
+  class Tree;
+
+  // FlatTree is a read-only copy of a Tree laid out in plain arrays, for
+  //   the metrics that walk every node.  Nodes are numbered 0..Size()-1 in
+  //   the order a TreeIterator visits them, children before their parent,
+  //   so the root is the last node and a pass from the front sees every
+  //   subtree complete.  The children of node i are
+  //   [ChildBegin(i), ChildEnd(i)) in the same order as in the tree.
+  //
+  // A FlatTree does not refer back to the tree or its organisms, so it
+  //   stays valid after both are gone.
+  class FlatTree
+  {
+  public:
+    static const unsigned int NoParent = ~0u;
+
+  private:
+    std::vector<unsigned int> parents;
+    // Children of node i are children[childOffsets[i]..childOffsets[i+1]).
+    std::vector<unsigned int> childOffsets;
+    std::vector<unsigned int> children;
+    std::vector<int>          ids;
+    std::vector<double>       birthTimes;
+
+  public:
+    // Throws 0 if the tree's nodes are not linked consistently.
+    explicit FlatTree(const Tree &) throw(int);
+    ~FlatTree(void);
+
+    const unsigned int Size(void) const
+    {
+      return static_cast<unsigned int>(parents.size());
+    }
+    // NoParent if the tree is empty.
+    const unsigned int Root(void) const
+    {
+      return (parents.empty()) ? NoParent : Size() - 1;
+    }
+
+    const unsigned int GetParent(const unsigned int i) const
+    {
+      return parents[i];
+    }
+    const unsigned int HowManyChildren(const unsigned int i) const
+    {
+      return childOffsets[i+1] - childOffsets[i];
+    }
+    const unsigned int *ChildBegin(const unsigned int i) const
+    {
+      return children.data() + childOffsets[i];
+    }
+    const unsigned int *ChildEnd(const unsigned int i) const
+    {
+      return children.data() + childOffsets[i+1];
+    }
+
+    const int    GetId(const unsigned int i)        const { return ids[i]; }
+    const double GetBirthTime(const unsigned int i) const
+    {
+      return birthTimes[i];
+    }
+
+    // Fills order with the nodes in breadth first order from the root.
+    //   The caller's vector is reused, so repeated calls do not allocate.
+    void LevelOrder(std::vector<unsigned int> &order) const;
+
+  private:
+    FlatTree(const FlatTree &);
+    const FlatTree &operator=(const FlatTree &);
+  };
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_FlatTree_h__
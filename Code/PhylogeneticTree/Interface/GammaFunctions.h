@@ -21,12 +21,17 @@ class OutputStream;
 
 namespace PhylogeneticTree
 {
+  class FlatTree;
   class Tree;
 
   double ComputeGamma(const Tree &,
                       const double timeCutoff,
                       const char *const outFilename,
                       OutputStream &output) throw(int);
+  double ComputeGamma(const FlatTree &,
+                      const double timeCutoff,
+                      const char *const outFilename,
+                      OutputStream &output) throw(int);
 
 } // namespace PhylogeneticTree
 
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PhylogeneticTree_Interface_IdIndex_h__
+#define __PhylogeneticTree_Interface_IdIndex_h__
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace PhylogeneticTree
+{
+
+  // IdIndex maps organism ids to dense slots, e.g. positions in a table.
+  //   Avida hands out ids in order from zero, so they index an array
+  //   directly.  Once the ids are too spread out for that to be cheap, the
+  //   index moves them into an open addressing hash table instead.  Either
+  //   way a lookup is a single probe in the common case, with none of the
+  //   pointer chasing of std::map.
+  class IdIndex
+  {
+  public:
+    static const unsigned int Missing = ~0u;
+
+  private:
+    // Direct mode: slot of id i at direct[i], Missing if none.
+    std::vector<unsigned int> direct;
+    // Hash mode: (id, slot) pairs, empty entries have the slot Missing.
+    std::vector<std::pair<int, unsigned int> > table;
+    // 32 less log2 of the table size, so Home keeps the top bits.
+    unsigned int shift;
+    unsigned int count;
+    unsigned int reserved;
+    bool         hashed;
+
+  public:
+    IdIndex(void);
+    ~IdIndex(void);
+
+    // Returns false, leaving the index unchanged, if the id is present.
+    const bool         Insert(const int id, const unsigned int slot);
+    // Both return false if the id is not present.
+    const bool         Erase(const int id);
+    const bool         Update(const int id, const unsigned int slot);
+    // Returns Missing if the id is not present.
+    const unsigned int Find(const int id) const;
+    void               Clear(void);
+    // Also tells the index how many ids to expect, so ids that arrive out
+    //   of order can still be kept in the array.
+    void               Reserve(const unsigned int);
+    const unsigned int Size(void) const { return count; }
+
+  private:
+    const bool   FitsDirect(const int id) const;
+    void         GrowDirect(const int id);
+    void         MoveToTable(void);
+    void         GrowTable(const unsigned int capacity);
+    const std::size_t Home(const int id) const;
+    const std::size_t Probe(const int id) const;
+  };
+
+  inline const unsigned int IdIndex::Find(const int id) const
+  {
+    if(!hashed)
+    {
+      return (id >= 0 && static_cast<std::size_t>(id) < direct.size())
+        ? direct[static_cast<std::size_t>(id)] : Missing;
+    }
+
+    return (table.empty()) ? Missing : table[Probe(id)].second;
+  }
+
+  inline const std::size_t IdIndex::Home(const int id) const
+  {
+    // Fibonacci hashing.  The product's top bits depend on every bit of
+    //   the id, while its low bits only depend on the id's low bits, so
+    //   ids a power of two apart would share a few homes under a mask.
+    return (static_cast<unsigned int>(id) * 2654435769u) >> shift;
+  }
+
+  inline const std::size_t IdIndex::Probe(const int id) const
+  {
+    const std::size_t mask = table.size() - 1;
+    std::size_t i = Home(id);
+    while(table[i].second != Missing && table[i].first != id)
+    {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_IdIndex_h__
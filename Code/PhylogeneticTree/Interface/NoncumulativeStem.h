@@ -21,12 +21,17 @@ class OutputStream;
 
 namespace PhylogeneticTree
 {
+  class FlatTree;
   class Tree;
 
   double NoncumulativeStem(const Tree &,
                            const double timeCutoff,
                            const char *const outFilename,
                            OutputStream &output) throw(int);
+  double NoncumulativeStem(const FlatTree &,
+                           const double timeCutoff,
+                           const char *const outFilename,
+                           OutputStream &output) throw(int);
 
 } // namespace PhylogeneticTree
 
@@ -0,0 +1,131 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PhylogeneticTree_Interface_OrganismTable_h__
+#define __PhylogeneticTree_Interface_OrganismTable_h__
+
+#include <vector>
+
+#include "PhylogeneticTree/Interface/iOrganism.h"
+
+namespace PhylogeneticTree
+{
+  class TreeBuilder;
+
+  // OrganismTable stores organisms column by column, one contiguous array
+  //   per field, instead of as individually allocated objects.  It holds
+  //   the fields every tree needs; organism types with more data derive
+  //   from it and add their own columns.
+  //
+  // A Tree can be built directly from the table; its nodes copy the
+  //   columns of their row and answer iTreeNode::GetData themselves, so
+  //   they do not refer back to the table.  GetRow makes a Row, a small
+  //   iOrganism that reads a row in place, and returns it by value; a Row
+  //   must not outlive the table or a Clear.  A Tree can be extended with
+  //   rows appended after it was built.
+  //
+  // A TreeBuilder attached to the table is given every row as it is
+  //   appended, so the tree's shape is known as soon as loading ends.
+  class OrganismTable
+  {
+  public:
+    class Row : public iOrganism
+    {
+    private:
+      const OrganismTable *table;
+      unsigned int index;
+
+    public:
+      Row(const OrganismTable &t, const unsigned int i)
+        : table(&t), index(i) { return; }
+
+      const int    GetId(void)        const { return table->GetId(index);   }
+      const int    GetParentId(void)  const
+      { return table->GetParentId(index); }
+      const double GetBirthTime(void) const
+      { return table->GetBirthTime(index); }
+      const bool   GetIsAlive(void)   const
+      { return table->GetIsAlive(index); }
+
+      const unsigned int GetIndex(void) const { return index; }
+    };
+
+  private:
+    std::vector<int>    ids;
+    std::vector<int>    parentIds;
+    std::vector<double> birthTimes;
+    std::vector<char>   alive;
+    TreeBuilder        *builder;
+
+  public:
+    OrganismTable(void);
+    virtual ~OrganismTable(void);
+
+    void               Append(const int id, const int parentId,
+                              const double birthTime, const bool isAlive);
+    void               Append(const OrganismTable &);
+    virtual void       Clear(void);
+    virtual void       Reserve(const unsigned int);
+    const unsigned int Size(void) const;
+
+    // Clears the builder and gives it the rows already in the table.  Pass 0
+    //   to detach it.  The builder must outlive the table or be detached.
+    void               SetTreeBuilder(TreeBuilder *);
+    TreeBuilder       *GetTreeBuilder(void) const { return builder; }
+
+    const int    GetId(const unsigned int i)        const;
+    const int    GetParentId(const unsigned int i)  const;
+    const double GetBirthTime(const unsigned int i) const;
+    const bool   GetIsAlive(const unsigned int i)   const;
+    const Row    GetRow(const unsigned int i)       const;
+
+    void SetIsAlive(const unsigned int i, const bool isAlive);
+
+  private:
+    OrganismTable(const OrganismTable &);
+    const OrganismTable &operator=(const OrganismTable &);
+  };
+
+  // Defined here so the columns can be read without a function call.
+  inline const int OrganismTable::GetId(const unsigned int i) const
+  {
+    return ids[i];
+  }
+
+  inline const int OrganismTable::GetParentId(const unsigned int i) const
+  {
+    return parentIds[i];
+  }
+
+  inline const double OrganismTable::GetBirthTime(const unsigned int i) const
+  {
+    return birthTimes[i];
+  }
+
+  inline const bool OrganismTable::GetIsAlive(const unsigned int i) const
+  {
+    return alive[i] != 0;
+  }
+
+  inline const OrganismTable::Row OrganismTable::GetRow(const unsigned int i)
+    const
+  {
+    return Row(*this, i);
+  }
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_OrganismTable_h__
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __PhylogeneticTree_Interface_SubtreeSampler_h__
+#define __PhylogeneticTree_Interface_SubtreeSampler_h__
+
+#include <vector>
+
+#include "PhylogeneticTree/Interface/AncestorIndex.h"
+
+class RandomNumberGenerator;
+
+namespace PhylogeneticTree
+{
+  class Tree;
+
+  // SubtreeSampler samples a tree's leaves without replacement like
+  //   Sample, but draws only the leaves it keeps and builds the sample
+  //   from them instead of copying the whole tree and burning the others.
+  //   The sample holds the leaves and the common ancestors where their
+  //   lineages branch, which are the common ancestors of neighbouring
+  //   leaves in preorder.  For the same leaves that is the tree Sample
+  //   gives after RemoveNonfurcatingNodes.  A sample of k leaves takes k
+  //   random numbers and O(k log k) time, however many leaves the tree has.
+  //
+  // The sampler reads the tree when it is made, so make it again after
+  //   the tree changes.  Sample only reads the sampler's own arrays, not
+  //   the tree's indexes, so threads may share one.
+  class SubtreeSampler
+  {
+  private:
+    AncestorIndex ancestors;
+    // Preorder positions of the leaves in the order GetLeaves lists them.
+    std::vector<unsigned int> leaves;
+    // By preorder position: the node, and one past the position of its
+    //   last descendant.
+    std::vector<TreeIterator> nodes;
+    std::vector<unsigned int> ends;
+
+  public:
+    explicit SubtreeSampler(const Tree &) throw(int);
+    ~SubtreeSampler(void);
+
+    // Replaces the contents of the sample tree, reusing its memory.
+    void Sample(const unsigned int howManyLeaves,
+                RandomNumberGenerator &,
+                Tree &sample) const throw(int);
+
+  private:
+    SubtreeSampler(const SubtreeSampler &);
+    const SubtreeSampler &operator=(const SubtreeSampler &);
+  };
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_SubtreeSampler_h__
@@ -0,0 +1,57 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __PhylogeneticTree_Interface_SubtreeSums_h__
+#define __PhylogeneticTree_Interface_SubtreeSums_h__
+
+#include <vector>
+
+namespace PhylogeneticTree
+{
+  class iOrganism;
+  class Tree;
+  class TreeIterator;
+
+  // SubtreeSums totals one value per organism over the subtree of any node
+  //   in constant time.  It keeps prefix sums of the values in the tree's
+  //   preorder, where every subtree is a run of positions (see
+  //   Tree::GetInterval).  The sums are taken when it is made, so make it
+  //   again after the tree changes.
+  class SubtreeSums
+  {
+  private:
+    const Tree &tree;
+    // sums[p] is the total of the values before position p.
+    std::vector<double> sums;
+
+  public:
+    SubtreeSums(const Tree &,
+                const double (*value)(const iOrganism &)) throw(int);
+    ~SubtreeSums(void);
+
+    // Both throw 0 for End or a deleted node.
+    const double Sum(const TreeIterator &)  const throw(int);
+    const double Mean(const TreeIterator &) const throw(int);
+
+  private:
+    SubtreeSums(const SubtreeSums &);
+    const SubtreeSums &operator=(const SubtreeSums &);
+  };
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_SubtreeSums_h__
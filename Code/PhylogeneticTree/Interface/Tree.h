@@ -17,32 +17,81 @@
 #ifndef __PhylogeneticTree_Interface_Tree_h__
 #define __PhylogeneticTree_Interface_Tree_h__
 
+#include <atomic>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <utility>
 
 #include "PhylogeneticTree/Interface/TreeIterator.h"
 
 namespace PhylogeneticTree
 {
+  class DfsIndex;
+  class FlatTree;
+  class IdIndex;
+  class NodePool;
   class TreeNode;
   class iOrganism;
+  class OrganismTable;
+  class TreeBuilder;
 
   class Tree
   {
   private:
     TreeNode *root;
     std::vector<TreeNode*> treeNodes;
+    // Owns the memory of every node in treeNodes.
+    NodePool *pool;
+    // Slot of each node by organism id.  Built by the first Find and kept
+    //   up to date after that; 0 until then.
+    mutable std::atomic<IdIndex*> idIndex;
+    // Leaves in the order a TreeIterator visits them, each node knowing its
+    //   position, listed when first asked for.  Deleted leaves leave End
+    //   behind.  DeleteSingle changes depths and Extend adds leaves in the
+    //   middle, so both drop the list.
+    mutable std::vector<TreeIterator> leaves;
+    mutable bool leavesListed;
+    // degrees[k] is the number of nodes with k children.
+    std::vector<unsigned int> degrees;
+    // Set by DeleteLeaf and DeleteSingle.  Node i is then no longer
+    //   sure to be table row i, which Extend relies on.
+    bool nodesDeleted;
+    // Preorder positions, numbered by the first query after the tree
+    //   changes; 0 until the first query.
+    mutable std::atomic<DfsIndex*> dfsIndex;
+    // Held while Ids or Positions builds its index, so that threads
+    //   reading the same tree build each index only once.  An index that
+    //   is already built is read without it.
+    mutable std::mutex indexLock;
 
   public:
+    // An empty tree, e.g. to copy other trees into.
+    Tree(void);
     Tree(const std::vector<iOrganism*> &) throw(int);
+    // The nodes copy their rows, so the table may be cleared afterwards.
+    Tree(const OrganismTable &) throw(int);
+    // Builds the tree in one pass from a table and the builder that was
+    //   attached to it while it was loaded.  Throws 4 if a parent is
+    //   missing and 5 if the builder does not match the table.
+    Tree(const OrganismTable &, const TreeBuilder &) throw(int);
     Tree(const std::map<int,int> &, std::vector<iOrganism*> &output) throw(int);
     Tree(const Tree &) throw(int);
+    // Takes over the other tree's nodes and leaves it empty.
+    Tree(Tree &&) throw();
     ~Tree(void);
 
+    // Copying into a tree keeps the memory of the nodes it had and reuses
+    //   it for the new ones.
     const Tree &operator=(const Tree &) throw(int);
+    const Tree &operator=(Tree &&) throw();
 
     TreeIterator              Begin(void)        const throw(int);
     void                      ClearDeleted(void);
+    // Makes the other tree a copy of this one, the same as other = *this.
+    //   Copying into the same tree again and again, as when sampling,
+    //   allocates next to nothing once its memory has grown to fit.
+    void                      CopyInto(Tree &) const throw(int);
     // For both DeleteLeaf and DeleteSingle
     // Removes it from tree, but does not delete it only marks it for delete
     //   To actually delete the node in a proper fashion causes some
@@ -51,9 +100,50 @@ namespace PhylogeneticTree
     //   difference is significant.
     void                      DeleteLeaf(TreeIterator &);
     void                      DeleteSingle(TreeIterator &);
+    // Deletes each leaf in the list and then clears the deleted nodes once,
+    //   so k leaves take O(n + k) rather than k calls to ClearDeleted.
+    //   Entries that are not leaves, or were already deleted, are skipped.
+    void                      DeleteLeaves(std::vector<TreeIterator> &);
     TreeIterator              End(void)          const;
+    // Adds nodes for the rows appended to the table since the tree was
+    //   built from it and the builder.  Every new row must have a parent
+    //   already in the tree (throws 4).  No node may have been deleted
+    //   from the tree or its copies since it was built, so that node i is
+    //   still row i (throws 5).  Nodes already in the tree pick up rows
+    //   marked dead since.
+    void                      Extend(const OrganismTable &,
+                                     const TreeBuilder &) throw(int);
+    // Both return End for an id that is not in the tree.  Finding a node
+    //   takes constant time; the iterator counts its depth up from the
+    //   node only if GetDepth or a traversal needs it.  The first Find
+    //   builds the id index, and may be made from several threads at once.
     TreeIterator              Find(const int id) const throw(int);
+    std::vector<TreeIterator> Find(const std::vector<int> &ids) const
+                                throw(int);
+    // Entry k is the number of nodes with k children.
+    const std::vector<unsigned int> &GetDegreeCounts(void) const;
+    // The preorder position of the node and one past that of its last
+    //   descendant, so its subtree is the positions [first, second).  With
+    //   prefix sums over the positions any subtree total is one
+    //   subtraction; see SubtreeSums.  The first query after the tree
+    //   changes numbers the nodes; unlike GetLeaves, that query may be
+    //   made from several threads at once.  These throw 0 for End or a
+    //   deleted node, and GetPosition throws 0 past the last position.
+    std::pair<unsigned int, unsigned int>
+                              GetInterval(const TreeIterator &) const
+                                throw(int);
+    TreeIterator              GetPosition(const unsigned int) const
+                                throw(int);
+    // The first call lists the leaves and later calls reuse the list, as
+    //   do copies of the tree.  Copying never writes to the tree copied
+    //   from, but call this once before sharing a tree between threads.
     std::vector<TreeIterator> GetLeaves(void)    const throw(int);
+    const unsigned int        HowManyLeaves(void) const;
+    // Leaves and nodes in the subtree of the node, itself included.
+    const unsigned int        HowManyLeaves(const TreeIterator &) const
+                                throw(int);
+    const unsigned int        HowManyNodes(const TreeIterator &) const
+                                throw(int);
     TreeIterator              Last(void)         const;
     TreeIterator              Root(void)         const;
     const unsigned int        Size(void)         const;
@@ -61,9 +151,27 @@ namespace PhylogeneticTree
   private:
     void CleanUp(void);
     void Copy(const Tree &) throw(int);
+    // Replaces this tree with copies of the nodes, which may be from
+    //   another tree.  parents[i] is the place of node i's parent earlier
+    //   in the list, or -1 for the root, and children come in list order.
+    void CopyNodes(const std::vector<TreeIterator> &nodes,
+                   const std::vector<int> &parents) throw(int);
+    void CountDegrees(void);
+    const IdIndex &Ids(void) const;
+    void ListLeaves(void) const throw(int);
+    void Take(Tree &);
+    const DfsIndex &Positions(void) const throw(int);
+    const unsigned int PositionSlot(const TreeIterator &) const throw(int);
+    void LinkNodes(const IdIndex &idToSlot) throw(int);
     void ProcessOrganisms(const std::vector<iOrganism*> &) throw(int);
+    void ProcessOrganisms(const OrganismTable &) throw(int);
+    void ProcessOrganisms(const OrganismTable &,
+                          const TreeBuilder &) throw(int);
     void ConstructLayout(const std::map<int,int> &,
                          std::vector<iOrganism*> &output) throw(int);
+
+    friend class FlatTree;
+    friend class SubtreeSampler;
   };
 
 } // namespace PhylogeneticTree
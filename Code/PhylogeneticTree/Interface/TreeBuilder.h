@@ -0,0 +1,82 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PhylogeneticTree_Interface_TreeBuilder_h__
+#define __PhylogeneticTree_Interface_TreeBuilder_h__
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "PhylogeneticTree/Interface/IdIndex.h"
+
+namespace PhylogeneticTree
+{
+
+  // TreeBuilder works out the shape of a tree while its organisms are
+  //   still being loaded.  Every organism added gets the next node slot,
+  //   its id is checked against the ids already seen, and it is linked to
+  //   its parent's slot as soon as the parent has been added.  Children
+  //   that arrive before their parent wait for it, so once loading is done
+  //   the only work left is to check that nothing is still waiting.
+  //
+  // Attach a builder to an OrganismTable to have it fed as rows are
+  //   appended, then build the Tree from both in a single linear pass.
+  class TreeBuilder
+  {
+  public:
+    // Parent slot of a root.
+    static const int NoParent = -1;
+
+  private:
+    static const int Waiting = -2;
+
+    IdIndex idToSlot;
+    std::vector<int> parentSlots;
+    // Slots of the children still waiting for each missing parent id.
+    std::unordered_map<int, std::vector<unsigned int> > waiting;
+    std::set<int> duplicateIds;
+
+  public:
+    TreeBuilder(void);
+    ~TreeBuilder(void);
+
+    void               Add(const int id, const int parentId);
+    void               Clear(void);
+    void               Reserve(const unsigned int);
+    const unsigned int Size(void) const;
+
+    // Throws 4 if the parent of some organism was never added.
+    void                 Finish(void) const throw(int);
+    // Returns the slot of the first organism added with the id, or -1.
+    const int            FindSlot(const int id) const;
+    const std::set<int> &GetDuplicateIds(void) const;
+    // Only valid once Finish has succeeded.
+    const int            GetParentSlot(const unsigned int slot) const;
+
+  private:
+    TreeBuilder(const TreeBuilder &);
+    const TreeBuilder &operator=(const TreeBuilder &);
+  };
+
+  inline const int TreeBuilder::GetParentSlot(const unsigned int slot) const
+  {
+    return parentSlots[slot];
+  }
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_TreeBuilder_h__
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PhylogeneticTree_Interface_TreeCache_h__
+#define __PhylogeneticTree_Interface_TreeCache_h__
+
+#include <vector>
+
+namespace PhylogeneticTree
+{
+  class Tree;
+  class OrganismTable;
+
+  // A tree cache is a binary snapshot of a prepared tree that lets later
+  //   runs on the same input files skip loading and preparing it.  It holds
+  //   the id, parent index, birth time and alive status of every node in
+  //   preorder, so a Tree built from the rows it loads has the same shape and
+  //   child order as the tree that was saved.
+  //
+  // Each cache records the size, modification time and a hash of every input
+  //   file along with an options value for anything else that changes the
+  //   tree, and it is only loaded if all of them still match.  The file is
+  //   written in native byte order and is not portable between machines.
+
+  // Throws 1 if an input file can not be read and 2 if the cache can not be
+  //   written.  The cache is written to a temporary file first so a failed
+  //   save never leaves a partial cache behind.
+  void SaveTreeCache(const Tree &,
+                     const char * const cacheFilename,
+                     const std::vector<const char*> &inputFilenames,
+                     const long long options) throw(int);
+
+  // Appends the cached nodes to organisms, with each parent id set to the id
+  //   of its parent in the prepared tree, and returns true.  Returns false,
+  //   adding nothing, if there is no cache or it does not match the inputs.
+  //   Throws 1 if an input file can not be read and 2 if the cache is
+  //   damaged.
+  const bool LoadTreeCache(OrganismTable &organisms,
+                           const char * const cacheFilename,
+                           const std::vector<const char*> &inputFilenames,
+                           const long long options) throw(int);
+
+} // namespace PhylogeneticTree
+
+#endif // __PhylogeneticTree_Interface_TreeCache_h__
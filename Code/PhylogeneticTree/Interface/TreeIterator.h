@@ -17,11 +17,14 @@
 #ifndef __PhylogeneticTree_Interface_TreeIterator_h__
 #define __PhylogeneticTree_Interface_TreeIterator_h__
 
+#include <cstddef>
 #include <vector>
 
 namespace PhylogeneticTree
 {
+  class ChildRange;
   class iTreeNode;
+  class LevelIterator;
   class TreeNode;
 
   // The TreeIterator uses a specific ordering for tree traversal.
@@ -34,8 +37,12 @@ namespace PhylogeneticTree
   class TreeIterator
   {
   private:
+    // An iterator made from a node alone, as Tree::Find does, counts its
+    //   depth up to the root only when the depth is first needed.
+    static const int UnknownDepth = -1;
+
     TreeNode *node;
-    int depth;
+    mutable int depth;
 
     TreeIterator(TreeNode *startNode=0, int depth=0);
 
@@ -54,11 +61,17 @@ namespace PhylogeneticTree
 
     // Data Access
     const iTreeNode *operator*(void) const; // dereference
-    int GetDepth(void) const { return depth; }
+    int GetDepth(void) const
+    {
+      if(depth == UnknownDepth) { CountDepth(); }
+      return depth;
+    }
     TreeIterator GetParent(void) const;
     std::vector<TreeIterator> GetChildren(void) const;
+    ChildRange Children(void) const;
 
   private:
+    void CountDepth(void) const;
     void Next_Depth(void);
     void Previous_Depth(void);
 
@@ -66,6 +79,8 @@ namespace PhylogeneticTree
     friend const bool operator==(const TreeIterator &, const TreeIterator &);
     friend const bool operator!=(const TreeIterator &, const TreeIterator &);
 
+    friend class ChildRange;
+    friend class LevelIterator;
     friend class Tree;
   };
 
@@ -73,6 +88,75 @@ namespace PhylogeneticTree
   const bool operator==(const TreeIterator &, const TreeIterator &);
   const bool operator!=(const TreeIterator &, const TreeIterator &);
 
+  // A view of a node's children that does not copy them.  It stays valid
+  //   until children are added to or removed from the node.
+  class ChildRange
+  {
+  public:
+    class const_iterator
+    {
+    private:
+      TreeNode * const *child;
+      int depth;
+
+    public:
+      const_iterator(TreeNode * const *child=0, int depth=0);
+
+      TreeIterator operator*(void) const;
+      void operator++(void);
+
+      const bool operator==(const const_iterator &) const;
+      const bool operator!=(const const_iterator &) const;
+    };
+
+  private:
+    TreeNode * const *first;
+    TreeNode * const *last;
+    int depth;
+
+    ChildRange(TreeNode * const *first, TreeNode * const *last, int depth);
+
+  public:
+    const_iterator begin(void) const;
+    const_iterator end(void)   const;
+
+    const std::size_t Size(void) const;
+    TreeIterator operator[](const std::size_t) const;
+
+    friend class TreeIterator;
+  };
+
+  // Visits a subtree in breadth first order, all of a node's children
+  //   before any of its grandchildren.  The nodes waiting to be visited
+  //   are kept in one buffer, which is reused when the iterator is Reset.
+  class LevelIterator
+  {
+  private:
+    std::vector<TreeNode*> buffer;
+    std::size_t current;
+    std::size_t levelEnd;
+    int depth;
+
+    LevelIterator(const LevelIterator &);
+    const LevelIterator &operator=(const LevelIterator &);
+
+  public:
+    LevelIterator(void);
+    explicit LevelIterator(const TreeIterator &start);
+    ~LevelIterator(void);
+
+    void Reset(const TreeIterator &start);
+
+    // Traversal
+    void operator++(void); // prefix
+    const bool Done(void) const;
+
+    // Data Access
+    const iTreeNode *operator*(void) const; // dereference
+    int GetDepth(void) const { return depth; }
+    TreeIterator Get(void) const;
+  };
+
 } // namespace PhylogeneticTree
 
 #endif // __PhylogeneticTree_Interface_TreeIterator_h__
@@ -17,7 +17,9 @@
 #ifndef __PhylogeneticTree_Interface_Utilities_h__
 #define __PhylogeneticTree_Interface_Utilities_h__
 
+#include <memory>
 #include <ostream>
+#include <vector>
 
 class RandomNumberGenerator;
 
@@ -29,6 +31,10 @@ namespace PhylogeneticTree
   // BurnLeaf takes the index of a node to remove.  If the node is a leaf 
   //   it burns all node parents above it until it reaches a bifurcation.
   void BurnLeaf(Tree &, TreeIterator &);
+  // The same for every leaf in the list, but the deleted nodes are only
+  //   cleared from the tree once at the end, so the cost is one pass over
+  //   the tree plus the nodes burned rather than a pass per leaf.
+  void BurnLeaves(Tree &, std::vector<TreeIterator> &);
 
   // Incomplete
   const bool CyclesFound(const Tree &);
@@ -50,9 +56,15 @@ namespace PhylogeneticTree
   //   specifies how many leaf nodes, up to the total leaf nodes, that will 
   //   be sampled without replacement.  These new leaf nodes will then be 
   //   used to create a new tree that is returned.
-  Tree *Sample(const Tree &,
-               const unsigned int howManyLeaves,
-               RandomNumberGenerator &) throw(int);
+  std::unique_ptr<Tree> Sample(const Tree &,
+                               const unsigned int howManyLeaves,
+                               RandomNumberGenerator &) throw(int);
+  // The same, but the sample replaces the contents of the last tree and
+  //   reuses its memory.  Pass the same tree for every sample in a loop.
+  void Sample(const Tree &,
+              const unsigned int howManyLeaves,
+              RandomNumberGenerator &,
+              Tree &sample) throw(int);
 
   // Incomplete
   const bool Validate(const Tree &);
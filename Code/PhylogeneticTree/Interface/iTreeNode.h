@@ -24,12 +24,26 @@ namespace PhylogeneticTree
   class iTreeNode
   {
   protected:
+    // Copies of the organism's fields, set when the node is made.
+    double birthTime;
+    int    id;
+    int    parentId;
+    bool   isAlive;
+
+    iTreeNode(void) : birthTime(0), id(0), parentId(0), isAlive(false) {}
     // The outside world should not be deleting iTreeNodes
     virtual ~iTreeNode(void) { return; }
 
   public:
     virtual const iOrganism   &GetData(void)         const = 0;
     virtual const unsigned int HowManyChildren(void) const = 0;
+
+    // The same as asking GetData, but without a virtual call or a visit to
+    //   the organism.  GetData is only needed for the rest of the record.
+    const double GetBirthTime(void) const { return birthTime; }
+    const int    GetId(void)        const { return id; }
+    const bool   GetIsAlive(void)   const { return isAlive; }
+    const int    GetParentId(void)  const { return parentId; }
   };
 
 } // namespace PhylogeneticTree
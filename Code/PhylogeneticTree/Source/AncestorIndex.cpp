@@ -0,0 +1,205 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <utility>
+
+#include "PhylogeneticTree/Interface/AncestorIndex.h"
+
+#include "PhylogeneticTree/Interface/iTreeNode.h"
+#include "PhylogeneticTree/Interface/Tree.h"
+
+using namespace std;
+
+// Positions per block; ranges inside a block, and the partial blocks at
+//   the ends of longer ranges, are scanned.
+static const unsigned int blockSize = 32;
+
+PhylogeneticTree::AncestorIndex::AncestorIndex(const Tree &t) throw(int)
+: tree(t)
+{
+  const unsigned int size =
+    (*tree.Root() != 0) ? tree.HowManyNodes(tree.Root()) : 0;
+
+  depths.resize(size);
+  parents.resize(size);
+  for(unsigned int p = 0; p < size; ++p)
+  {
+    const TreeIterator node = tree.GetPosition(p);
+    depths[p] = node.GetDepth();
+
+    const TreeIterator parent = node.GetParent();
+    parents[p] = (*parent != 0) ? tree.GetInterval(parent).first : p;
+  }
+
+  // Level 0 holds each block's shallowest position, and level k combines
+  //   two runs of level k-1.
+  const unsigned int blocks = (size + blockSize - 1) / blockSize;
+  if(blocks == 0) { return; }
+
+  blockMinimums.push_back(vector<unsigned int>(blocks));
+  for(unsigned int j = 0; j < blocks; ++j)
+  {
+    const unsigned int last = min(size, (j + 1) * blockSize) - 1;
+    unsigned int best = j * blockSize;
+    for(unsigned int p = best + 1; p <= last; ++p) { best = Shallower(best, p); }
+    blockMinimums[0][j] = best;
+  }
+
+  for(unsigned int k = 1; (1u << k) <= blocks; ++k)
+  {
+    const vector<unsigned int> &previous = blockMinimums[k-1];
+    const unsigned int half = 1u << (k - 1);
+
+    vector<unsigned int> level(blocks - (1u << k) + 1);
+    for(unsigned int j = 0; j < level.size(); ++j)
+    {
+      level[j] = Shallower(previous[j], previous[j + half]);
+    }
+    blockMinimums.push_back(level);
+  }
+
+  return;
+}
+
+PhylogeneticTree::AncestorIndex::~AncestorIndex(void)
+{
+  return;
+}
+
+PhylogeneticTree::TreeIterator
+PhylogeneticTree::AncestorIndex::FindCommonAncestor(const TreeIterator &a,
+                                                    const TreeIterator &b)
+  const throw(int)
+{
+  const unsigned int p = tree.GetInterval(a).first;
+  const unsigned int q = tree.GetInterval(b).first;
+  if(p >= depths.size() || q >= depths.size()) { throw 0; }
+
+  return tree.GetPosition(CommonAncestor(p, q));
+}
+
+PhylogeneticTree::TreeIterator
+PhylogeneticTree::AncestorIndex::FindCommonAncestor(
+  const vector<TreeIterator> &nodes) const throw(int)
+{
+  if(nodes.empty()) { return tree.End(); }
+
+  // The ancestor of the first and last in preorder is the ancestor of all.
+  unsigned int first = static_cast<unsigned int>(depths.size());
+  unsigned int last = 0;
+  vector<TreeIterator>::const_iterator i = nodes.begin();
+  for(; i != nodes.end(); ++i)
+  {
+    const unsigned int p = tree.GetInterval(*i).first;
+    if(p >= depths.size()) { throw 0; }
+
+    if(p < first) { first = p; }
+    if(p > last)  { last = p; }
+  }
+
+  return tree.GetPosition(CommonAncestor(first, last));
+}
+
+const unsigned int
+PhylogeneticTree::AncestorIndex::FindCommonAncestor(const unsigned int p,
+                                                    const unsigned int q)
+  const throw(int)
+{
+  if(p >= depths.size() || q >= depths.size()) { throw 0; }
+  return CommonAncestor(p, q);
+}
+
+const int
+PhylogeneticTree::AncestorIndex::Distance(const TreeIterator &a,
+                                          const TreeIterator &b)
+  const throw(int)
+{
+  const unsigned int p = tree.GetInterval(a).first;
+  const unsigned int q = tree.GetInterval(b).first;
+  if(p >= depths.size() || q >= depths.size()) { throw 0; }
+
+  const unsigned int ancestor = CommonAncestor(p, q);
+
+  return depths[p] + depths[q] - 2 * depths[ancestor];
+}
+
+const double
+PhylogeneticTree::AncestorIndex::TimeDistance(const TreeIterator &a,
+                                              const TreeIterator &b)
+  const throw(int)
+{
+  const double ancestorBorn =
+    (*FindCommonAncestor(a, b))->GetBirthTime();
+
+  return ((*a)->GetBirthTime() - ancestorBorn) +
+         ((*b)->GetBirthTime() - ancestorBorn);
+}
+
+const unsigned int
+PhylogeneticTree::AncestorIndex::CommonAncestor(const unsigned int p,
+                                                const unsigned int q) const
+{
+  if(p == q) { return p; }
+
+  const unsigned int first = (p < q) ? p : q;
+  const unsigned int last  = (p < q) ? q : p;
+
+  return parents[Shallowest(first + 1, last)];
+}
+
+const unsigned int
+PhylogeneticTree::AncestorIndex::Shallower(const unsigned int p,
+                                           const unsigned int q) const
+{
+  return (depths[q] < depths[p]) ? q : p;
+}
+
+const unsigned int
+PhylogeneticTree::AncestorIndex::Shallowest(const unsigned int first,
+                                            const unsigned int last) const
+{
+  const unsigned int firstBlock = first / blockSize;
+  const unsigned int lastBlock  = last / blockSize;
+
+  unsigned int best = first;
+  if(lastBlock - firstBlock < 2)
+  {
+    for(unsigned int p = first + 1; p <= last; ++p) { best = Shallower(best, p); }
+    return best;
+  }
+
+  // Scan the partial blocks at the ends and look up the whole ones between.
+  for(unsigned int p = first + 1; p < (firstBlock + 1) * blockSize; ++p)
+  {
+    best = Shallower(best, p);
+  }
+  for(unsigned int p = lastBlock * blockSize; p <= last; ++p)
+  {
+    best = Shallower(best, p);
+  }
+
+  const unsigned int from = firstBlock + 1;
+  const unsigned int count = lastBlock - from;
+  unsigned int k = 0;
+  while((2u << k) <= count) { ++k; }
+
+  best = Shallower(best, blockMinimums[k][from]);
+  best = Shallower(best, blockMinimums[k][lastBlock - (1u << k)]);
+
+  return best;
+}
@@ -25,9 +25,8 @@
 
 #include "PhylogeneticTree/Interface/Balance.h"
 
+#include "PhylogeneticTree/Interface/FlatTree.h"
 #include "PhylogeneticTree/Interface/Tree.h"
-#include "PhylogeneticTree/Interface/TreeIterator.h"
-#include "PhylogeneticTree/Interface/iTreeNode.h"
 #include "PhylogeneticTree/Interface/iOrganism.h"
 #include "Support/Interface/OutputStream.h"
 
@@ -40,8 +39,11 @@ struct BalanceNode
   vector<BalanceNode*> children;
 };
 
-const bool ValidateValues(const Tree &tree, const map<int, int> &data);
-double ComputeIC(const Tree &tree, const map<int, int> &data) throw(int);
+const bool GetValues(const FlatTree &tree, const map<int, int> &data,
+                     vector<int> &values);
+const bool ValidateValues(const FlatTree &tree, const vector<int> &data,
+                          vector<unsigned int> &order);
+double ComputeIC(const FlatTree &tree, const vector<int> &data);
 Tree *ConstructTree(int leaves, int internals, map<int, int> &data,
                     vector<iOrganism*> &organisms) throw(int);
 void CleanupMin(Tree **tree, vector<iOrganism*> &organisms);
@@ -53,15 +55,27 @@ double PhylogeneticTree::ComputeBalance(const Tree &tree,
                                         ostream &reportCsv,
                                         ostream &listTxt,
                                         ostream &listCsv) throw(int)
+{
+  const FlatTree flat(tree);
+  return ComputeBalance(flat, output, generateReport,
+                        reportTxt, reportCsv, listTxt, listCsv);
+}
+
+double PhylogeneticTree::ComputeBalance(const FlatTree &tree,
+                                        OutputStream &output,
+                                        const bool generateReport,
+                                        ostream &reportTxt,
+                                        ostream &reportCsv,
+                                        ostream &listTxt,
+                                        ostream &listCsv) throw(int)
 {
   // Figure out how many leaves and internal nodes are present in the data tree
   int internals = 0;
   int leaves = 0;
 
-  TreeIterator i = tree.Begin();
-  for(; i != tree.End(); ++i)
+  for(unsigned int i = 0; i < tree.Size(); ++i)
   {
-    int children = (*i)->HowManyChildren();
+    int children = tree.HowManyChildren(i);
     if(children == 0) ++leaves;
     else ++internals;
   }
@@ -94,30 +108,23 @@ double PhylogeneticTree::ComputeBalance(const Tree &tree,
   }
 
   // Prepare Data Tree
-  map<int, int> dataLeafCount;
-
-  vector<TreeIterator> originalLeaves = tree.GetLeaves();
-  vector<TreeIterator>::iterator leaf = originalLeaves.begin();
-  for(; leaf != originalLeaves.end(); ++leaf)
+  // Count the leaves in each node's subtree.  Children come before their
+  //   parent, so a node's count is complete when it is added to its parent.
+  vector<int> dataLeafCount(tree.Size(), 0);
+  for(unsigned int i = 0; i < tree.Size(); ++i)
   {
-    TreeIterator ti = *leaf;
-
-    // Proceed up the tree to the root adding one to each internal node's
-    //   subtree leaf count
-    while(ti != tree.End())
-    {
-      int id = (*ti)->GetData().GetId();
-
-      map<int, int>::iterator mib = dataLeafCount.find(id);
-      if(mib == dataLeafCount.end()) dataLeafCount.insert(make_pair(id, 1));
-      else ++mib->second;
+    if(tree.HowManyChildren(i) == 0) dataLeafCount[i] = 1;
 
-      ti.Up();
-    }
+    const unsigned int parent = tree.GetParent(i);
+    if(parent != FlatTree::NoParent) dataLeafCount[parent] += dataLeafCount[i];
   }
 
+  // Breadth first order of the tree being checked, reused by every check
+  //   and by the list output.
+  vector<unsigned int> order;
+
   // Verify that the values calculated in the last step add up at all depths
-  if(ValidateValues(tree, dataLeafCount) == false)
+  if(ValidateValues(tree, dataLeafCount, order) == false)
   {
     output << "Error: Subtree leaf counts incorrect." << endl;
     throw 4;
@@ -145,14 +152,17 @@ double PhylogeneticTree::ComputeBalance(const Tree &tree,
   }
 
   // Verify that the values calculated in the last step add up at all depths
-  if(ValidateValues(*minTree, minData) == false)
+  const FlatTree minFlat(*minTree);
+  vector<int> minValues;
+  if(GetValues(minFlat, minData, minValues) == false ||
+     ValidateValues(minFlat, minValues, order) == false)
   {
     output << "Error: Subtree leaf counts incorrect." << endl;
     throw 5;
   }
 
   // Compute IC
-  double ic_min = ComputeIC(*minTree, minData);
+  double ic_min = ComputeIC(minFlat, minValues);
 
   CleanupMin(&minTree, organisms);
 
@@ -175,14 +185,17 @@ double PhylogeneticTree::ComputeBalance(const Tree &tree,
   }
 
   // Verify that the values calculated in the last step add up at all depths
-  if(ValidateValues(*minTree_bin, minData_bin) == false)
+  const FlatTree minFlat_bin(*minTree_bin);
+  vector<int> minValues_bin;
+  if(GetValues(minFlat_bin, minData_bin, minValues_bin) == false ||
+     ValidateValues(minFlat_bin, minValues_bin, order) == false)
   {
     output << "Error: Subtree leaf counts incorrect." << endl;
     throw 6;
   }
 
   // Compute IC
-  double ic_min_bin = ComputeIC(*minTree_bin, minData_bin);
+  double ic_min_bin = ComputeIC(minFlat_bin, minValues_bin);
 
   CleanupMin(&minTree_bin, organisms_bin);
 
@@ -230,36 +243,25 @@ double PhylogeneticTree::ComputeBalance(const Tree &tree,
   output << " , " << ic_max/ic_max << endl;
 
   // Output list file
-  i = tree.Root(); // TreeIterator i, from beginning of function
-  queue<TreeIterator> listQ;
-  listQ.push(i);
+  tree.LevelOrder(order);
 
-  while(!listQ.empty())
+  vector<unsigned int>::const_iterator li = order.begin();
+  for(; li != order.end(); ++li)
   {
-    i = listQ.front();
-    listQ.pop();
+    const unsigned int i = *li;
 
-    int numChildren = (*i)->HowManyChildren();
-    int id          = (*i)->GetData().GetId();
-    int updateBorn  = (*i)->GetData().GetBirthTime();
+    int numChildren = tree.HowManyChildren(i);
+    int id          = tree.GetId(i);
+    int updateBorn  = tree.GetBirthTime(i);
 
     listTxt << id << " "  << updateBorn << " "  << numChildren;
     listCsv << id << ", " << updateBorn << ", " << numChildren;
 
-    vector<TreeIterator> children = i.GetChildren();
-    vector<TreeIterator>::iterator ci = children.begin();
-    for(; ci != children.end(); ++ci)
+    const unsigned int *ci = tree.ChildBegin(i);
+    for(; ci != tree.ChildEnd(i); ++ci)
     {
-      int childId = (**ci)->GetData().GetId();
-
-      map<int, int>::iterator mib = dataLeafCount.find(childId);
-      if(mib == dataLeafCount.end()) throw 7;
-
-      listTxt << " "  << mib->second;
-      listCsv << ", " << mib->second;
-
-      // Add each child to the queue
-      listQ.push(*ci);
+      listTxt << " "  << dataLeafCount[*ci];
+      listCsv << ", " << dataLeafCount[*ci];
     }
 
     listTxt << endl;
@@ -269,45 +271,50 @@ double PhylogeneticTree::ComputeBalance(const Tree &tree,
   return ic_data;
 }
 
-const bool ValidateValues(const Tree &tree, const map<int, int> &data)
+const bool GetValues(const FlatTree &tree, const map<int, int> &data,
+                     vector<int> &values)
+{
+  values.assign(tree.Size(), 0);
+  for(unsigned int i = 0; i < tree.Size(); ++i)
+  {
+    map<int, int>::const_iterator mib = data.find(tree.GetId(i));
+    if(mib == data.end()) return false;
+
+    values[i] = mib->second;
+  }
+
+  return true;
+}
+
+const bool ValidateValues(const FlatTree &tree, const vector<int> &data,
+                          vector<unsigned int> &order)
 {
-  queue<TreeIterator> q;
-  q.push(tree.Root());
+  if(tree.Size() == 0) return false;
 
-  map<int,int>::const_iterator rit = data.find((*tree.Root())->GetData().GetId());
-  if(rit == data.end()) return false;
+  tree.LevelOrder(order);
 
-  int total = rit->second;
+  int total = data[tree.Root()];
 
-  int depth = 1;
+  // A level ends where the nodes queued by the level before it end.
+  size_t levelEnd = 1;
+  size_t queued = 1;
   int sum = 0;
   int leavesUsed = 0;
-  while(!q.empty())
+  for(size_t i = 0; i < order.size(); ++i)
   {
-    TreeIterator ti = q.front();
-    q.pop();
+    const unsigned int node = order[i];
 
-    int id = (*ti)->GetData().GetId();
-    int currentDepth = ti.GetDepth();
-
-    rit = data.find(id);
-    if(rit == data.end()) return false;
-
-    if(currentDepth != depth)
+    if(i == levelEnd)
     {
       if(sum != total) return false;
 
-      sum = rit->second + leavesUsed;
-      depth = currentDepth;
+      sum = leavesUsed;
+      levelEnd = queued;
     }
-    else
-      sum += rit->second;
+    sum += data[node];
 
-    if((*ti)->HowManyChildren() == 0) ++leavesUsed;
-
-    vector<TreeIterator> children = ti.GetChildren();
-    vector<TreeIterator>::iterator temp = children.begin();
-    for(; temp != children.end(); ++temp) q.push(*temp);
+    if(tree.HowManyChildren(node) == 0) ++leavesUsed;
+    queued += tree.HowManyChildren(node);
   }
 
   if(sum != total) return false;
@@ -315,36 +322,25 @@ const bool ValidateValues(const Tree &tree, const map<int, int> &data)
   return true;
 }
 
-double ComputeIC(const Tree &tree, const map<int, int> &data) throw(int)
+double ComputeIC(const FlatTree &tree, const vector<int> &data)
 {
   double ic = 0;
 
-  TreeIterator ti = tree.Begin();
-  for(; ti != tree.End(); ++ti)
+  for(unsigned int i = 0; i < tree.Size(); ++i)
   {
-    if((*ti)->HowManyChildren() == 0) continue; // skip children
-    if((*ti)->HowManyChildren() == 1) continue; // skip single leaf parents
+    if(tree.HowManyChildren(i) == 0) continue; // skip children
+    if(tree.HowManyChildren(i) == 1) continue; // skip single leaf parents
 
     // Do all pairs difference in child values
-    vector<TreeIterator> children = ti.GetChildren();
-    vector<TreeIterator>::iterator child = children.begin();
+    const unsigned int *begin = tree.ChildBegin(i);
+    const unsigned int *end   = tree.ChildEnd(i);
     double value = 0;
     double counter = 0;
-    for(; child != children.end(); ++child)
+    for(const unsigned int *child = begin; child != end; ++child)
     {
-      int id = (**child)->GetData().GetId();
-      map<int, int>::const_iterator mib = data.find(id);
-      if(mib == data.end()) throw -1;
-
-      vector<TreeIterator>::iterator temp = child;
-      ++temp;
-      for(; temp != children.end(); ++temp)
+      for(const unsigned int *temp = child + 1; temp != end; ++temp)
       {
-        int id2 = (**temp)->GetData().GetId();
-        map<int, int>::const_iterator mib2 = data.find(id2);
-        if(mib2 == data.end()) throw -2;
-
-        value += static_cast<double>(abs(mib->second - mib2->second));
+        value += static_cast<double>(abs(data[*child] - data[*temp]));
         counter += 1;
       }
     }
@@ -430,13 +426,10 @@ Tree *ConstructTree(int leaves, int internals, map<int, int> &data,
     rootChildren.erase(rrcMax);
 
     // Remove child from the tree
-    map<int,int>::iterator mii = layout.begin();
-    for(; mii != layout.end(); ++mii)
-      if(mii->first == childId)
-        layout.erase(mii);
+    layout.erase(childId);
 
     // Change all nodes who's parent is the child, and set it to the root
-    mii = layout.begin();
+    map<int,int>::iterator mii = layout.begin();
     for(; mii != layout.end(); ++mii)
       if(mii->second == childId)
       {
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <utility>
+
+#include "PhylogeneticTree/Include/DfsIndex.h"
+
+#include "PhylogeneticTree/Include/TreeNode.h"
+
+using namespace std;
+
+PhylogeneticTree::DfsIndex::DfsIndex(void)
+: built(false)
+{
+  return;
+}
+
+PhylogeneticTree::DfsIndex::~DfsIndex(void)
+{
+  return;
+}
+
+void PhylogeneticTree::DfsIndex::Build(TreeNode *root,
+                                       const unsigned int slots) throw(int)
+{
+  built = false;
+  enter.assign(slots, 0);
+  exit.assign(slots, 0);
+  nodes.clear();
+  depths.clear();
+  leafPrefix.assign(1, 0);
+
+  if(root == 0)
+  {
+    built = true;
+    return;
+  }
+
+  // (node, next child to visit).  A node gets its position when it is
+  //   pushed and its exit when its last child is done.
+  vector<pair<TreeNode*, unsigned int> > stack;
+  TreeNode *node = root;
+  while(node != 0)
+  {
+    const unsigned int slot = node->GetSlot();
+    if(slot >= slots || nodes.size() >= slots) { throw 0; }
+
+    enter[slot] = static_cast<unsigned int>(nodes.size());
+    nodes.push_back(node);
+    depths.push_back(static_cast<int>(stack.size()) + 1);
+    leafPrefix.push_back(leafPrefix.back() +
+                         ((node->HowManyChildren() == 0) ? 1 : 0));
+    stack.push_back(make_pair(node, 0u));
+
+    node = 0;
+    while(node == 0 && !stack.empty())
+    {
+      TreeNode *top = stack.back().first;
+      unsigned int &next = stack.back().second;
+      if(next < top->HowManyChildren())
+      {
+        node = top->GetChildren()[next];
+        ++next;
+        continue;
+      }
+
+      exit[top->GetSlot()] = static_cast<unsigned int>(nodes.size());
+      stack.pop_back();
+    }
+  }
+
+  built = true;
+
+  return;
+}
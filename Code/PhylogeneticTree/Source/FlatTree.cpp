@@ -0,0 +1,134 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utility>
+
+#include "PhylogeneticTree/Interface/FlatTree.h"
+
+#include "PhylogeneticTree/Interface/Tree.h"
+#include "PhylogeneticTree/Include/TreeNode.h"
+
+using namespace std;
+
+const unsigned int PhylogeneticTree::FlatTree::NoParent;
+
+PhylogeneticTree::FlatTree::FlatTree(const Tree &tree) throw(int)
+{
+  const vector<TreeNode*> &treeNodes = tree.treeNodes;
+
+  // Number the nodes reachable from the root in TreeIterator order with an
+  //   explicit stack of (node, next child) pairs.  index maps a node's slot
+  //   in the tree to its number here, NoParent until it is numbered.
+  vector<unsigned int> index(treeNodes.size(), NoParent);
+  unsigned int n = 0;
+
+  if(tree.root != 0)
+  {
+    vector<pair<TreeNode*, unsigned int> > stack;
+    stack.push_back(make_pair(tree.root, 0u));
+    while(!stack.empty())
+    {
+      TreeNode *node = stack.back().first;
+      const unsigned int next = stack.back().second;
+      if(next < node->HowManyChildren())
+      {
+        // A path longer than the tree has nodes means a cycle.
+        if(stack.size() > treeNodes.size()) { throw 0; }
+
+        ++stack.back().second;
+        stack.push_back(make_pair(node->GetChildren()[next], 0u));
+        continue;
+      }
+
+      const unsigned int slot = node->GetSlot();
+      if(slot >= treeNodes.size() || treeNodes[slot] != node ||
+         index[slot] != NoParent)
+      {
+        throw 0;
+      }
+
+      index[slot] = n++;
+      stack.pop_back();
+    }
+  }
+
+  parents.resize(n, NoParent);
+  childOffsets.resize(n + 1, 0);
+  ids.resize(n);
+  birthTimes.resize(n);
+
+  // Fill the arrays in slot order rather than in DFS order.  Slots follow
+  //   the order the nodes and their organisms were made in, so the reads
+  //   walk through memory instead of jumping around it.
+  for(unsigned int slot = 0; slot < treeNodes.size(); ++slot)
+  {
+    const unsigned int i = index[slot];
+    if(i == NoParent) { continue; } // not reachable from the root
+
+    const TreeNode *node = treeNodes[slot];
+    ids[i] = node->GetId();
+    birthTimes[i] = node->GetBirthTime();
+
+    if(node->GetParent() != 0)
+    {
+      parents[i] = index[node->GetParent()->GetSlot()];
+    }
+    childOffsets[i+1] = node->HowManyChildren();
+  }
+
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    childOffsets[i+1] += childOffsets[i];
+  }
+
+  children.resize(childOffsets[n]);
+  for(unsigned int slot = 0; slot < treeNodes.size(); ++slot)
+  {
+    const unsigned int i = index[slot];
+    if(i == NoParent) { continue; }
+
+    unsigned int next = childOffsets[i];
+    const TreeNode::ChildList &nodeChildren = treeNodes[slot]->GetChildren();
+    TreeNode::ChildList::const_iterator c = nodeChildren.begin();
+    for(; c != nodeChildren.end(); ++c)
+    {
+      children[next++] = index[(*c)->GetSlot()];
+    }
+  }
+
+  return;
+}
+
+PhylogeneticTree::FlatTree::~FlatTree(void)
+{
+  return;
+}
+
+void PhylogeneticTree::FlatTree::LevelOrder(vector<unsigned int> &order) const
+{
+  order.clear();
+  if(parents.empty()) { return; }
+
+  // The order itself is the queue: nodes before i have been expanded.
+  order.reserve(Size());
+  order.push_back(Root());
+  for(size_t i = 0; i < order.size(); ++i)
+  {
+    order.insert(order.end(), ChildBegin(order[i]), ChildEnd(order[i]));
+  }
+
+  return;
+}
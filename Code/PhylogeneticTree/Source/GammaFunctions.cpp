@@ -24,10 +24,8 @@
 
 #include "PhylogeneticTree/Interface/GammaFunctions.h"
 
+#include "PhylogeneticTree/Interface/FlatTree.h"
 #include "PhylogeneticTree/Interface/Tree.h"
-#include "PhylogeneticTree/Interface/TreeIterator.h"
-#include "PhylogeneticTree/Interface/iTreeNode.h"
-#include "PhylogeneticTree/Interface/iOrganism.h"
 #include "Support/Interface/OutputStream.h"
 
 using namespace PhylogeneticTree;
@@ -37,6 +35,15 @@ double PhylogeneticTree::ComputeGamma(const Tree &tree,
                                       const double timeCutoff,
                                       const char *const outFilename,
                                       OutputStream &output) throw(int)
+{
+  const FlatTree flat(tree);
+  return ComputeGamma(flat, timeCutoff, outFilename, output);
+}
+
+double PhylogeneticTree::ComputeGamma(const FlatTree &tree,
+                                      const double timeCutoff,
+                                      const char *const outFilename,
+                                      OutputStream &output) throw(int)
 {
   /*** map furcation time to number of new lineages at that time point ******/
   output << "Building map of time to new lineages     ... ";
@@ -56,13 +63,12 @@ double PhylogeneticTree::ComputeGamma(const Tree &tree,
   multimap<double, pair<unsigned int, int> >::iterator iIdMap = idMap.end();
 
   // Add each furcation to the branches map, and record id
-  TreeIterator iTree = tree.End();
-  for(iTree = tree.Begin(); iTree != tree.End(); ++iTree)
+  for(unsigned int i = 0; i < tree.Size(); ++i)
   {
-    const double furcationTime = (*iTree)->GetData().GetBirthTime();
+    const double furcationTime = tree.GetBirthTime(i);
     if(furcationTime >= timeCutoff) { continue; } // skip these furcations
 
-    const unsigned int children = (*iTree)->HowManyChildren();
+    const unsigned int children = tree.HowManyChildren(i);
     if(children < 2) { continue; } // ignore leaf nodes and non-furcations
 
     iBranches = branches.find(furcationTime);
@@ -75,7 +81,7 @@ double PhylogeneticTree::ComputeGamma(const Tree &tree,
       iBranches->second += children - 1;
     }
 
-    const int id = (*iTree)->GetData().GetId();
+    const int id = tree.GetId(i);
     idMap.insert(make_pair(furcationTime, make_pair(children - 1, id)));
   }
   output << "Complete." << endl;;
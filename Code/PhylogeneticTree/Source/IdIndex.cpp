@@ -0,0 +1,203 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PhylogeneticTree/Interface/IdIndex.h"
+
+using namespace std;
+
+const unsigned int PhylogeneticTree::IdIndex::Missing;
+
+// Ids may spread over this many array entries per id stored (plus a fixed
+//   allowance) before the index switches to the hash table.
+static const size_t directSpread = 4;
+static const size_t directAllowance = 1<<16;
+
+const unsigned int HashShift(const size_t capacity);
+
+PhylogeneticTree::IdIndex::IdIndex(void)
+: shift(32), count(0), reserved(0), hashed(false)
+{
+  return;
+}
+
+PhylogeneticTree::IdIndex::~IdIndex(void)
+{
+  return;
+}
+
+const bool PhylogeneticTree::IdIndex::Insert(const int id,
+                                             const unsigned int slot)
+{
+  if(!hashed && !FitsDirect(id)) { MoveToTable(); }
+
+  if(!hashed)
+  {
+    if(static_cast<size_t>(id) >= direct.size()) { GrowDirect(id); }
+    if(direct[static_cast<size_t>(id)] != Missing) { return false; }
+    direct[static_cast<size_t>(id)] = slot;
+    ++count;
+    return true;
+  }
+
+  // Keep the table at most half full so probe sequences stay short.
+  if((count + 1) * 2 > table.size())
+  {
+    GrowTable(static_cast<unsigned int>((table.empty()) ? 1024
+                                                        : table.size() * 2));
+  }
+
+  const size_t i = Probe(id);
+  if(table[i].second != Missing) { return false; }
+  table[i] = make_pair(id, slot);
+  ++count;
+
+  return true;
+}
+
+const bool PhylogeneticTree::IdIndex::Erase(const int id)
+{
+  if(!hashed)
+  {
+    if(Find(id) == Missing) { return false; }
+    direct[static_cast<size_t>(id)] = Missing;
+    --count;
+    return true;
+  }
+
+  if(table.empty()) { return false; }
+  size_t i = Probe(id);
+  if(table[i].second == Missing) { return false; }
+
+  // Close the gap so later probes do not stop early: move back each entry
+  //   after it whose home is not between the gap and the entry.
+  const size_t mask = table.size() - 1;
+  for(size_t j = (i + 1) & mask; table[j].second != Missing; j = (j + 1) & mask)
+  {
+    const size_t home = Home(table[j].first);
+    const bool stays = (i <= j) ? (i < home && home <= j)
+                                : (i < home || home <= j);
+    if(stays) { continue; }
+
+    table[i] = table[j];
+    i = j;
+  }
+  table[i].second = Missing;
+  --count;
+
+  return true;
+}
+
+const bool PhylogeneticTree::IdIndex::Update(const int id,
+                                             const unsigned int slot)
+{
+  if(Find(id) == Missing) { return false; }
+
+  if(!hashed) { direct[static_cast<size_t>(id)] = slot; }
+  else        { table[Probe(id)].second = slot; }
+
+  return true;
+}
+
+void PhylogeneticTree::IdIndex::Clear(void)
+{
+  // swap with empty vectors to release the memory as well
+  vector<unsigned int>().swap(direct);
+  vector<pair<int, unsigned int> >().swap(table);
+  shift = 32;
+  count = 0;
+  reserved = 0;
+  hashed = false;
+
+  return;
+}
+
+void PhylogeneticTree::IdIndex::Reserve(const unsigned int size)
+{
+  if(size > reserved) { reserved = size; }
+  if(!hashed) { return; }
+
+  size_t capacity = table.size();
+  while(capacity < static_cast<size_t>(size) * 2) { capacity *= 2; }
+  if(capacity > table.size())
+  {
+    GrowTable(static_cast<unsigned int>(capacity));
+  }
+
+  return;
+}
+
+const bool PhylogeneticTree::IdIndex::FitsDirect(const int id) const
+{
+  const size_t expected = (count > reserved) ? count : reserved;
+  return id >= 0 &&
+         static_cast<size_t>(id) < (expected + 1) * directSpread +
+                                   directAllowance;
+}
+
+void PhylogeneticTree::IdIndex::GrowDirect(const int id)
+{
+  // Grow geometrically so adding ids in order is amortized constant time.
+  size_t size = direct.size() * 2;
+  if(size <= static_cast<size_t>(id)) { size = static_cast<size_t>(id) + 1; }
+  direct.resize(size, Missing);
+
+  return;
+}
+
+void PhylogeneticTree::IdIndex::MoveToTable(void)
+{
+  hashed = true;
+
+  size_t capacity = 1024;
+  while(capacity < static_cast<size_t>(count) * 2 + 2) { capacity *= 2; }
+  table.assign(capacity, make_pair(0, Missing));
+  shift = HashShift(capacity);
+
+  for(size_t id = 0; id < direct.size(); ++id)
+  {
+    if(direct[id] != Missing)
+    {
+      table[Probe(static_cast<int>(id))] =
+        make_pair(static_cast<int>(id), direct[id]);
+    }
+  }
+  vector<unsigned int>().swap(direct);
+
+  return;
+}
+
+void PhylogeneticTree::IdIndex::GrowTable(const unsigned int capacity)
+{
+  vector<pair<int, unsigned int> > old(capacity, make_pair(0, Missing));
+  old.swap(table);
+  shift = HashShift(capacity);
+
+  vector<pair<int, unsigned int> >::const_iterator i = old.begin();
+  for(; i != old.end(); ++i)
+  {
+    if(i->second != Missing) { table[Probe(i->first)] = *i; }
+  }
+
+  return;
+}
+
+const unsigned int HashShift(const size_t capacity)
+{
+  // capacity is a power of two
+  unsigned int shift = 32;
+  for(size_t c = capacity; c > 1; c >>= 1) { --shift; }
+  return shift;
+}
@@ -60,7 +60,7 @@ void PhylogeneticTree::NewickOutput(const Tree &tree,
   {
     TreeIterator sc2 = tree.Begin();
     if(*sc2 == 0) { outFile.close(); throw 2; }
-    outFile << "()F" << (*sc2)->GetData().GetId() << endl;
+    outFile << "()F" << (*sc2)->GetId() << endl;
     outFile.close();
     output << "Complete." << endl;
     return;
@@ -79,8 +79,8 @@ void PhylogeneticTree::NewickOutput(const Tree &tree,
     const TreeIterator parent = (i.GetParent() != end) ? i.GetParent() : i;
     if(*i == 0 || *parent == 0) { outFile.close(); throw 3; }
 
-    const iOrganism & org = (*i)->GetData();
-    const iOrganism & porg = (*parent)->GetData();
+    const iTreeNode &org = **i;
+    const iTreeNode &porg = **parent;
 
     const int diff = i.GetDepth() - depth;
     if(diff == 0)
@@ -0,0 +1,182 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <new>
+
+#include "PhylogeneticTree/Include/NodePool.h"
+
+#include "PhylogeneticTree/Include/TreeNode.h"
+
+using namespace std;
+
+const size_t PhylogeneticTree::NodePool::MinimumBlock;
+
+PhylogeneticTree::NodePool::NodePool(void)
+: arena(1 << 20), freeNodes(0), liveNodes(0)
+{
+  return;
+}
+
+PhylogeneticTree::NodePool::~NodePool(void)
+{
+  Clear();
+  return;
+}
+
+PhylogeneticTree::TreeNode *
+PhylogeneticTree::NodePool::Create(const iOrganism &data) throw(int)
+{
+  void *memory = NewNode();
+  try
+  {
+    return new (memory) TreeNode(data, *this);
+  }
+  catch(...)
+  {
+    FreeNode(memory);
+    throw 1;
+  }
+}
+
+PhylogeneticTree::TreeNode *
+PhylogeneticTree::NodePool::Create(const OrganismTable &organisms,
+                                   const unsigned int row) throw(int)
+{
+  void *memory = NewNode();
+  try
+  {
+    return new (memory) TreeNode(organisms, row, *this);
+  }
+  catch(...)
+  {
+    FreeNode(memory);
+    throw 1;
+  }
+}
+
+PhylogeneticTree::TreeNode *
+PhylogeneticTree::NodePool::Create(const TreeNode &other) throw(int)
+{
+  void *memory = NewNode();
+  try
+  {
+    return new (memory) TreeNode(other, *this);
+  }
+  catch(...)
+  {
+    FreeNode(memory);
+    throw 1;
+  }
+}
+
+void PhylogeneticTree::NodePool::Destroy(TreeNode *node)
+{
+  if(node == 0) { return; }
+
+  // The destructor hands the node's child list back to the pool.
+  node->~TreeNode();
+  FreeNode(node);
+
+  return;
+}
+
+void *PhylogeneticTree::NodePool::Allocate(const size_t size)
+{
+  const size_t k = SizeClass(size);
+  if(k < freeLists.size() && freeLists[k] != 0)
+  {
+    FreeBlock *block = freeLists[k];
+    freeLists[k] = block->next;
+    return block;
+  }
+
+  return arena.Allocate(MinimumBlock << k, sizeof(void*));
+}
+
+void PhylogeneticTree::NodePool::Deallocate(void *memory, const size_t size)
+{
+  if(memory == 0) { return; }
+
+  const size_t k = SizeClass(size);
+  if(k >= freeLists.size()) { freeLists.resize(k + 1, 0); }
+
+  FreeBlock *block = static_cast<FreeBlock*>(memory);
+  block->next = freeLists[k];
+  freeLists[k] = block;
+
+  return;
+}
+
+void PhylogeneticTree::NodePool::Clear(void)
+{
+  arena.Clear();
+  freeNodes = 0;
+  // swap with an empty vector to release its memory as well
+  vector<FreeBlock*>().swap(freeLists);
+  liveNodes = 0;
+
+  return;
+}
+
+void PhylogeneticTree::NodePool::Reset(void)
+{
+  arena.Reset();
+  freeNodes = 0;
+  freeLists.assign(freeLists.size(), 0);
+  liveNodes = 0;
+
+  return;
+}
+
+void PhylogeneticTree::NodePool::FreeNode(void *memory)
+{
+  FreeBlock *block = static_cast<FreeBlock*>(memory);
+  block->next = freeNodes;
+  freeNodes = block;
+  --liveNodes;
+
+  return;
+}
+
+void *PhylogeneticTree::NodePool::NewNode(void) throw(int)
+{
+  void *memory = freeNodes;
+  if(memory != 0)
+  {
+    freeNodes = freeNodes->next;
+  }
+  else
+  {
+    try
+    {
+      memory = arena.Allocate(sizeof(TreeNode), sizeof(void*));
+    }
+    catch(...)
+    {
+      throw 1;
+    }
+  }
+
+  ++liveNodes;
+  return memory;
+}
+
+const size_t PhylogeneticTree::NodePool::SizeClass(const size_t size)
+{
+  size_t k = 0;
+  while((MinimumBlock << k) < size) { ++k; }
+  return k;
+}
@@ -24,10 +24,8 @@
 
 #include "PhylogeneticTree/Interface/NoncumulativeStem.h"
 
+#include "PhylogeneticTree/Interface/FlatTree.h"
 #include "PhylogeneticTree/Interface/Tree.h"
-#include "PhylogeneticTree/Interface/TreeIterator.h"
-#include "PhylogeneticTree/Interface/iTreeNode.h"
-#include "PhylogeneticTree/Interface/iOrganism.h"
 #include "Support/Interface/OutputStream.h"
 
 using namespace PhylogeneticTree;
@@ -37,6 +35,15 @@ double PhylogeneticTree::NoncumulativeStem(const Tree &tree,
                                            const double timeCutoff,
                                            const char *const outFilename,
                                            OutputStream &output) throw(int)
+{
+  const FlatTree flat(tree);
+  return NoncumulativeStem(flat, timeCutoff, outFilename, output);
+}
+
+double PhylogeneticTree::NoncumulativeStem(const FlatTree &tree,
+                                           const double timeCutoff,
+                                           const char *const outFilename,
+                                           OutputStream &output) throw(int)
 {
   int total=0, leaves=0, extra=0, singles=0;
 
@@ -44,37 +51,32 @@ double PhylogeneticTree::NoncumulativeStem(const Tree &tree,
   double n = 0;
 
   // Get the birth time of the root
-  TreeIterator iRoot = tree.Root();
-  if(iRoot == tree.End()) return 0; // no root
-  if(*iRoot == 0)         throw(0); // no data
-  double rootTime = (*iRoot)->GetData().GetBirthTime();
+  const unsigned int root = tree.Root();
+  if(root == FlatTree::NoParent) return 0; // no root
+  double rootTime = tree.GetBirthTime(root);
 
-  for(TreeIterator iTree = tree.Begin(); iTree != tree.End(); ++iTree)
+  for(unsigned int i = 0; i < tree.Size(); ++i)
   {
-    if(*iTree == 0) throw(1); // no data
-
     ++total;
-    int children = (*iTree)->HowManyChildren();
+    int children = tree.HowManyChildren(i);
     if(children > 2) extra += children - 2;
     if(children == 1) ++singles;
     if(children == 0) ++leaves;
 
-    if(iTree == iRoot) continue; // don't process root node
+    if(i == root) continue; // don't process root node
 
-    const iOrganism &organism = (*iTree)->GetData();
-    if((*iTree)->HowManyChildren() == 0) continue; // ignore leaf nodes
+    if(children == 0) continue; // ignore leaf nodes
 
-    TreeIterator parent = iTree.GetParent();
-    if(*parent == 0) throw(2); //  no data
+    const unsigned int parent = tree.GetParent(i);
 
-    const double birthTime = organism.GetBirthTime();
-    const double parentBirthTime = (*parent)->GetData().GetBirthTime();
+    const double birthTime = tree.GetBirthTime(i);
+    const double parentBirthTime = tree.GetBirthTime(parent);
 
     // skewed times
     if(parentBirthTime > birthTime || parentBirthTime < rootTime) throw(3);
 
     // if the parent is the root, the ratio is 1
-    if(parent == iRoot)
+    if(parent == root)
     {
       sum += 1;
       n += 1;
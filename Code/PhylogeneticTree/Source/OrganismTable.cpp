@@ -0,0 +1,120 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PhylogeneticTree/Interface/OrganismTable.h"
+#include "PhylogeneticTree/Interface/TreeBuilder.h"
+
+using namespace std;
+
+PhylogeneticTree::OrganismTable::OrganismTable(void)
+: builder(0)
+{
+  return;
+}
+
+PhylogeneticTree::OrganismTable::~OrganismTable(void)
+{
+  return;
+}
+
+void PhylogeneticTree::OrganismTable::Append(const int id,
+                                             const int parentId,
+                                             const double birthTime,
+                                             const bool isAlive)
+{
+  ids.push_back(id);
+  parentIds.push_back(parentId);
+  birthTimes.push_back(birthTime);
+  alive.push_back((isAlive) ? 1 : 0);
+
+  if(builder != 0) { builder->Add(id, parentId); }
+
+  return;
+}
+
+void PhylogeneticTree::OrganismTable::Append(const OrganismTable &other)
+{
+  const unsigned int offset = Size();
+
+  ids.insert(ids.end(), other.ids.begin(), other.ids.end());
+  parentIds.insert(parentIds.end(), other.parentIds.begin(),
+                   other.parentIds.end());
+  birthTimes.insert(birthTimes.end(), other.birthTimes.begin(),
+                    other.birthTimes.end());
+  alive.insert(alive.end(), other.alive.begin(), other.alive.end());
+
+  if(builder != 0)
+  {
+    for(unsigned int i = offset; i < Size(); ++i)
+    {
+      builder->Add(ids[i], parentIds[i]);
+    }
+  }
+
+  return;
+}
+
+void PhylogeneticTree::OrganismTable::Clear(void)
+{
+  // swap with empty vectors to release the memory as well
+  vector<int>().swap(ids);
+  vector<int>().swap(parentIds);
+  vector<double>().swap(birthTimes);
+  vector<char>().swap(alive);
+
+  if(builder != 0) { builder->Clear(); }
+
+  return;
+}
+
+void PhylogeneticTree::OrganismTable::Reserve(const unsigned int size)
+{
+  ids.reserve(size);
+  parentIds.reserve(size);
+  birthTimes.reserve(size);
+  alive.reserve(size);
+
+  if(builder != 0) { builder->Reserve(size); }
+
+  return;
+}
+
+void PhylogeneticTree::OrganismTable::SetIsAlive(const unsigned int i,
+                                                 const bool isAlive)
+{
+  alive[i] = (isAlive) ? 1 : 0;
+  return;
+}
+
+void PhylogeneticTree::OrganismTable::SetTreeBuilder(TreeBuilder *b)
+{
+  builder = b;
+  if(builder == 0) { return; }
+
+  builder->Clear();
+  builder->Reserve(Size());
+  for(unsigned int i = 0; i < Size(); ++i)
+  {
+    builder->Add(ids[i], parentIds[i]);
+  }
+
+  return;
+}
+
+const unsigned int PhylogeneticTree::OrganismTable::Size(void) const
+{
+  return static_cast<unsigned int>(ids.size());
+}
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+
+#include "PhylogeneticTree/Interface/SubtreeSampler.h"
+
+#include "PhylogeneticTree/Interface/IdIndex.h"
+#include "PhylogeneticTree/Interface/Tree.h"
+#include "PhylogeneticTree/Interface/TreeIterator.h"
+#include "Support/Interface/random.h"
+
+using namespace std;
+
+PhylogeneticTree::SubtreeSampler::SubtreeSampler(const Tree &t) throw(int)
+: ancestors(t)
+{
+  const vector<TreeIterator> treeLeaves = t.GetLeaves();
+  leaves.reserve(treeLeaves.size());
+
+  vector<TreeIterator>::const_iterator i = treeLeaves.begin();
+  for(; i != treeLeaves.end(); ++i)
+  {
+    leaves.push_back(t.GetInterval(*i).first);
+  }
+
+  const unsigned int size =
+    (*t.Root() != 0) ? t.HowManyNodes(t.Root()) : 0;
+  nodes.reserve(size);
+  ends.reserve(size);
+  for(unsigned int p = 0; p < size; ++p)
+  {
+    nodes.push_back(t.GetPosition(p));
+    ends.push_back(t.GetInterval(nodes.back()).second);
+  }
+
+  return;
+}
+
+PhylogeneticTree::SubtreeSampler::~SubtreeSampler(void)
+{
+  return;
+}
+
+void PhylogeneticTree::SubtreeSampler::Sample(const unsigned int howManyLeaves,
+                                              RandomNumberGenerator &rng,
+                                              Tree &sample) const throw(int)
+{
+  /*** Draw the leaves to keep *********************************************/
+  // Floyd's algorithm: the draw for j picks one of the first j + 1 leaves,
+  //   and if that one is already kept it keeps leaf j instead.  Every set
+  //   of leaves is equally likely and no draw is thrown away.
+  const unsigned int size = static_cast<unsigned int>(leaves.size());
+  const unsigned int keep = (howManyLeaves < size) ? howManyLeaves : size;
+
+  IdIndex drawn;
+  drawn.Reserve(keep);
+  vector<unsigned int> kept;
+  kept.reserve(keep);
+  for(unsigned int j = size - keep; j < size; ++j)
+  {
+    unsigned int whichOne = rng.GetUInt(j + 1);
+    if(!drawn.Insert(static_cast<int>(whichOne), 0))
+    {
+      whichOne = j;
+      drawn.Insert(static_cast<int>(whichOne), 0);
+    }
+    kept.push_back(leaves[whichOne]);
+  }
+
+  /*** Find where the lineages branch ***************************************/
+  // Every branching node is the common ancestor of two leaves that are
+  //   next to each other in preorder.
+  sort(kept.begin(), kept.end());
+
+  vector<unsigned int> positions(kept);
+  for(unsigned int i = 1; i < kept.size(); ++i)
+  {
+    positions.push_back(ancestors.FindCommonAncestor(kept[i-1], kept[i]));
+  }
+
+  sort(positions.begin(), positions.end());
+  positions.erase(unique(positions.begin(), positions.end()),
+                  positions.end());
+
+  /*** Link each node to its closest ancestor in the sample *****************/
+  // In preorder a node's parent is the last node before it whose subtree
+  //   it is in, so the open subtrees are kept on a stack.
+  vector<TreeIterator> sampled;
+  vector<int> parents;
+  vector<int> open;
+  sampled.reserve(positions.size());
+  parents.reserve(positions.size());
+
+  // Sample node i is the node at positions[i].
+  vector<unsigned int>::const_iterator p = positions.begin();
+  for(; p != positions.end(); ++p)
+  {
+    while(!open.empty() && ends[positions[open.back()]] <= *p)
+    {
+      open.pop_back();
+    }
+
+    parents.push_back((open.empty()) ? -1 : open.back());
+    open.push_back(static_cast<int>(sampled.size()));
+    sampled.push_back(nodes[*p]);
+  }
+
+  sample.CopyNodes(sampled, parents);
+
+  return;
+}
@@ -0,0 +1,67 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <utility>
+
+#include "PhylogeneticTree/Interface/SubtreeSums.h"
+
+#include "PhylogeneticTree/Interface/iOrganism.h"
+#include "PhylogeneticTree/Interface/iTreeNode.h"
+#include "PhylogeneticTree/Interface/Tree.h"
+
+using namespace std;
+
+PhylogeneticTree::SubtreeSums::SubtreeSums(
+  const Tree &t, const double (*value)(const iOrganism &)) throw(int)
+: tree(t)
+{
+  const unsigned int size =
+    (*tree.Root() != 0) ? tree.HowManyNodes(tree.Root()) : 0;
+
+  sums.reserve(size + 1);
+  sums.push_back(0.0);
+  for(unsigned int p = 0; p < size; ++p)
+  {
+    sums.push_back(sums.back() + value((*tree.GetPosition(p))->GetData()));
+  }
+
+  return;
+}
+
+PhylogeneticTree::SubtreeSums::~SubtreeSums(void)
+{
+  return;
+}
+
+const double
+PhylogeneticTree::SubtreeSums::Sum(const TreeIterator &i) const throw(int)
+{
+  const pair<unsigned int, unsigned int> interval = tree.GetInterval(i);
+  if(interval.second >= sums.size()) { throw 0; }
+
+  return sums[interval.second] - sums[interval.first];
+}
+
+const double
+PhylogeneticTree::SubtreeSums::Mean(const TreeIterator &i) const throw(int)
+{
+  const pair<unsigned int, unsigned int> interval = tree.GetInterval(i);
+  if(interval.second >= sums.size()) { throw 0; }
+
+  return (sums[interval.second] - sums[interval.first]) /
+         static_cast<double>(interval.second - interval.first);
+}
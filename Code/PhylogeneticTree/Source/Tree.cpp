@@ -19,37 +19,83 @@
 #include "PhylogeneticTree/Interface/Tree.h"
 
 #include "Organisms/Interface/SimpleOrganism.h"
+#include "PhylogeneticTree/Interface/IdIndex.h"
 #include "PhylogeneticTree/Interface/iOrganism.h"
+#include "PhylogeneticTree/Interface/OrganismTable.h"
+#include "PhylogeneticTree/Interface/TreeBuilder.h"
+#include "PhylogeneticTree/Include/DfsIndex.h"
+#include "PhylogeneticTree/Include/NodePool.h"
 #include "PhylogeneticTree/Include/TreeNode.h"
 
 using namespace std;
 
 PhylogeneticTree::TreeNode *toDelete = 0;
 
+PhylogeneticTree::Tree::Tree(void)
+: root(0), pool(new NodePool), idIndex(0), leavesListed(false),
+  nodesDeleted(false), dfsIndex(0)
+{
+  return;
+}
+
 PhylogeneticTree::Tree::Tree(const vector<iOrganism*> &organisms) throw(int)
-: root(0)
+: root(0), pool(new NodePool), idIndex(0), leavesListed(false),
+  nodesDeleted(false), dfsIndex(0)
+{
+  ProcessOrganisms(organisms);
+  CountDegrees();
+  return;
+}
+
+PhylogeneticTree::Tree::Tree(const OrganismTable &organisms) throw(int)
+: root(0), pool(new NodePool), idIndex(0), leavesListed(false),
+  nodesDeleted(false), dfsIndex(0)
 {
   ProcessOrganisms(organisms);
+  CountDegrees();
+  return;
+}
+
+PhylogeneticTree::Tree::Tree(const OrganismTable &organisms,
+                             const TreeBuilder &builder) throw(int)
+: root(0), pool(new NodePool), idIndex(0), leavesListed(false),
+  nodesDeleted(false), dfsIndex(0)
+{
+  ProcessOrganisms(organisms, builder);
+  CountDegrees();
   return;
 }
 
 PhylogeneticTree::Tree::Tree(const map<int,int> &layout,
                              vector<iOrganism*> &output) throw(int)
-: root(0)
+: root(0), pool(new NodePool), idIndex(0), leavesListed(false),
+  nodesDeleted(false), dfsIndex(0)
 {
   ConstructLayout(layout, output);
+  CountDegrees();
   return;
 }
 
-PhylogeneticTree::Tree::Tree(const Tree &otherTree) throw(int) : root(0)
+PhylogeneticTree::Tree::Tree(const Tree &otherTree) throw(int)
+: root(0), pool(new NodePool), idIndex(0), leavesListed(false),
+  nodesDeleted(false), dfsIndex(0)
 {
   Copy(otherTree);
   return;
 }
 
+PhylogeneticTree::Tree::Tree(Tree &&otherTree) throw()
+: root(0), pool(0), idIndex(0), leavesListed(false),
+  nodesDeleted(false), dfsIndex(0)
+{
+  Take(otherTree);
+  return;
+}
+
 PhylogeneticTree::Tree::~Tree(void)
 {
   CleanUp();
+  delete pool;
   return;
 }
 
@@ -60,6 +106,18 @@ PhylogeneticTree::Tree::operator=(const Tree &otherTree) throw(int)
   return *this;
 }
 
+const PhylogeneticTree::Tree &
+PhylogeneticTree::Tree::operator=(Tree &&otherTree) throw()
+{
+  if(&otherTree != this)
+  {
+    CleanUp();
+    delete pool;
+    Take(otherTree);
+  }
+  return *this;
+}
+
 PhylogeneticTree::TreeIterator PhylogeneticTree::Tree::Begin(void) const throw(int)
 {
   if(root == 0)
@@ -80,20 +138,41 @@ PhylogeneticTree::TreeIterator PhylogeneticTree::Tree::Begin(void) const throw(i
   return TreeIterator(node, depth);
 }
 
+void PhylogeneticTree::Tree::CountDegrees(void)
+{
+  // Every node in the tree is in treeNodes, so no traversal is needed.
+  degrees.assign(1, 0);
+  for(unsigned int s = 0; s < treeNodes.size(); ++s)
+  {
+    if(treeNodes[s] == 0 || treeNodes[s]->GetDeleteMe()) { continue; }
+
+    const unsigned int children = treeNodes[s]->HowManyChildren();
+    if(children >= degrees.size()) { degrees.resize(children + 1, 0); }
+    ++degrees[children];
+  }
+
+  return;
+}
+
 void PhylogeneticTree::Tree::CleanUp(void)
 {
   root = 0;
 
-  unsigned int x = 0;
-  vector<TreeNode*>::iterator i = treeNodes.end();
-  for(i = treeNodes.begin(); i != treeNodes.end(); ++i, ++x)
-  {
-    if(*i != 0)
-    {
-      delete *i;
-      *i = 0;
-    }
-  }
+  // The pool releases every node at once, but keeps the memory in case
+  //   another tree is copied in.  A tree that was moved from has no pool.
+  treeNodes.clear();
+  if(pool != 0) { pool->Reset(); }
+
+  delete idIndex.load();
+  idIndex = 0;
+
+  leaves.clear();
+  leavesListed = false;
+  degrees.clear();
+  nodesDeleted = false;
+
+  delete dfsIndex.load();
+  dfsIndex = 0;
 
   return;
 }
@@ -119,8 +198,17 @@ void PhylogeneticTree::Tree::ClearDeleted(void)
       treeNodes[i] = treeNodes[treeNodes.size()-1];
       treeNodes[treeNodes.size()-1] = 0;
       treeNodes.pop_back();
-
-      if(node != 0) { delete node; }
+      if(i < treeNodes.size() && treeNodes[i] != 0)
+      {
+        treeNodes[i]->SetSlot(i);
+        if(idIndex != 0)
+        {
+          idIndex.load()->Update(treeNodes[i]->GetId(), i);
+        }
+      }
+
+      if(node != 0) { pool->Destroy(node); }
+      if(dfsIndex != 0) { dfsIndex.load()->Invalidate(); }
       continue;
     }
 
@@ -133,8 +221,10 @@ void PhylogeneticTree::Tree::ClearDeleted(void)
 void PhylogeneticTree::Tree::ConstructLayout(const map<int,int> &layout,
                                              vector<iOrganism*> &output) throw(int)
 {
-  // Temporary map of id to index used during the linking phase
-  map<int, TreeNode*> idToNode;
+  // Temporary index of id to slot used during the linking phase
+  IdIndex idToSlot;
+  idToSlot.Reserve(static_cast<unsigned int>(layout.size()));
+  treeNodes.reserve(layout.size());
 
   map<int,int>::const_iterator iLayout = layout.begin();
   for(; iLayout != layout.end(); ++iLayout)
@@ -144,17 +234,18 @@ void PhylogeneticTree::Tree::ConstructLayout(const map<int,int> &layout,
     try
     {
       so = new SimpleOrganism(iLayout->first, iLayout->second);
-      tn = new TreeNode(*so);
+      tn = pool->Create(*so);
       if(so == 0 || tn == 0) throw 0;
     }
     catch(...)
     {
       if(so != 0) delete so;
-      if(tn != 0) delete tn;
+      if(tn != 0) pool->Destroy(tn);
       throw 1;
     }
     output.push_back(so);
-    idToNode.insert(make_pair(so->GetId(), tn));
+    tn->SetSlot(static_cast<unsigned int>(treeNodes.size()));
+    idToSlot.Insert(so->GetId(), tn->GetSlot());
     treeNodes.push_back(tn);
     // check for error -- throw 2
   }
@@ -166,7 +257,7 @@ void PhylogeneticTree::Tree::ConstructLayout(const map<int,int> &layout,
   {
     // Assuming all treeNodes are valid, otherwise the above code would have 
     //   thrown 1.
-    int parentId = (*i)->GetData().GetParentId();
+    int parentId = (*i)->GetParentId();
     if(parentId == -1)
     {
       // The root has no parent so its parent will be set to itself
@@ -176,19 +267,18 @@ void PhylogeneticTree::Tree::ConstructLayout(const map<int,int> &layout,
     }
 
     // Look up the parent by id
-    map<int, TreeNode*>::iterator temp = idToNode.find(parentId);
-    if(temp == idToNode.end()) // Could not find parent
+    const unsigned int parentSlot = idToSlot.Find(parentId);
+    if(parentSlot == IdIndex::Missing) // Could not find parent
     {
       throw 3;
     }
 
-    // Assuming temp->second will not be 0, otherwise the above code would 
-    //   have thrown 1.
     // Set parent for current node
-    (*i)->SetParent(*(temp->second));
+    TreeNode *parent = treeNodes[parentSlot];
+    (*i)->SetParent(*parent);
 
     // Add this node as child for parent node
-    temp->second->InsertChild(**i);
+    parent->InsertChild(**i);
   }
 
   return;
@@ -197,63 +287,138 @@ void PhylogeneticTree::Tree::ConstructLayout(const map<int,int> &layout,
 void PhylogeneticTree::Tree::Copy(const Tree &otherTree) throw(int)
 {
   CleanUp();
+  if(pool == 0) { pool = new NodePool; }
 
-  map<TreeNode*, TreeNode*> oldToNewMap;
-
-  // Make copies of all the TreeNodes, but do not hook them up yet.
-  vector<TreeNode*>::const_iterator i = otherTree.treeNodes.end();
-  for(i = otherTree.treeNodes.begin(); i != otherTree.treeNodes.end(); ++i)
+  // Make copies of all the TreeNodes, each in the same slot as the node it
+  //   copies, but do not hook them up yet.
+  const vector<TreeNode*> &otherNodes = otherTree.treeNodes;
+  treeNodes.reserve(otherNodes.size());
+  for(unsigned int s = 0; s < otherNodes.size(); ++s)
   {
-    TreeNode *node = *i;
+    TreeNode *node = otherNodes[s];
     if(node == 0) { throw -1; }
 
-    TreeNode *tn = new TreeNode(node->GetData());
+    TreeNode *tn = pool->Create(*node);
     if(tn == 0) { throw -2; }
 
+    tn->SetSlot(s);
     treeNodes.push_back(tn);
-    oldToNewMap.insert(make_pair(node, tn));
-    // Check for error, throw 1
   }
 
-  // Hook up new TreeNodes
-  map<TreeNode*, TreeNode*>::iterator mi = oldToNewMap.end();
-  for(mi = oldToNewMap.begin(); mi != oldToNewMap.end(); ++mi)
+  // Hook up new TreeNodes.  The slot of an old node is the slot of its
+  //   copy, so no lookups are needed.
+  for(unsigned int s = 0; s < otherNodes.size(); ++s)
   {
-    // Assuming first and second are non-zero or the above code would have 
-    //   thrown 1.
-    TreeNode *oldNode = mi->first;
-    TreeNode *newNode = mi->second;
-
-    TreeNode *parent = oldNode->GetParent();
+    const TreeNode *oldNode = otherNodes[s];
+    TreeNode *newNode = treeNodes[s];
 
-    map<TreeNode*, TreeNode*>::iterator temp = oldToNewMap.end();
+    const TreeNode *parent = oldNode->GetParent();
     if(parent != 0)
     {
-      temp = oldToNewMap.find(parent);
-      // Check for error, throw 2
-      newNode->SetParent(*(temp->second));
+      newNode->SetParent(*treeNodes[parent->GetSlot()]);
     }
     else
     {
       newNode->SetAsRoot();
-      root = newNode;
     }
 
-    vector<TreeNode*>::const_iterator vi = oldNode->GetChildren().end();
-    for(vi = oldNode->GetChildren().begin(); vi != oldNode->GetChildren().end(); ++vi)
+    // A node waiting for ClearDeleted may still list a child that has
+    //   moved to another parent, so it only gets the same mark.
+    if(oldNode->GetDeleteMe())
+    {
+      newNode->SetDeleteMe(true);
+      continue;
+    }
+
+    // Each list of children is allocated once, at its final size.
+    const TreeNode::ChildList &children = oldNode->GetChildren();
+    newNode->ReserveChildren(static_cast<unsigned int>(children.size()));
+    TreeNode::ChildList::const_iterator vi = children.begin();
+    for(; vi != children.end(); ++vi)
+    {
+      newNode->InsertChild(*treeNodes[(*vi)->GetSlot()]);
+    }
+  }
+
+  root = (otherTree.root != 0) ? treeNodes[otherTree.root->GetSlot()] : 0;
+
+  // The leaves are copied the same way, dropping deleted ones.  The other
+  //   tree may be copied by several threads at once, so if its leaves are
+  //   not listed yet they are listed here in the copy instead.
+  degrees = otherTree.degrees;
+  nodesDeleted = otherTree.nodesDeleted;
+  if(!otherTree.leavesListed)
+  {
+    ListLeaves();
+    return;
+  }
+
+  leavesListed = true;
+  leaves.reserve(otherTree.HowManyLeaves());
+  vector<TreeIterator>::const_iterator li = otherTree.leaves.begin();
+  for(; li != otherTree.leaves.end(); ++li)
+  {
+    if(li->node == 0) { continue; }
+
+    TreeNode *leaf = treeNodes[li->node->GetSlot()];
+    leaf->SetLeafIndex(static_cast<unsigned int>(leaves.size()));
+    leaves.push_back(TreeIterator(leaf, li->depth));
+  }
+
+  return;
+}
+
+void PhylogeneticTree::Tree::CopyNodes(const vector<TreeIterator> &nodes,
+                                       const vector<int> &parents)
+  throw(int)
+{
+  CleanUp();
+  if(pool == 0) { pool = new NodePool; }
+  if(parents.size() != nodes.size()) { throw -1; }
+
+  treeNodes.reserve(nodes.size());
+  for(unsigned int s = 0; s < nodes.size(); ++s)
+  {
+    if(nodes[s].node == 0) { throw -1; }
+
+    TreeNode *tn = pool->Create(*nodes[s].node);
+    if(tn == 0) { throw -2; }
+
+    tn->SetSlot(s);
+    treeNodes.push_back(tn);
+  }
+
+  for(unsigned int s = 0; s < nodes.size(); ++s)
+  {
+    TreeNode *tn = treeNodes[s];
+    const int parent = parents[s];
+    if(parent < 0)
     {
-      temp = oldToNewMap.find(*vi);
-      // Check for error, throw 3
-      newNode->InsertChild(*(temp->second));
+      if(root != 0) { throw 3; } // Multiple roots
+      tn->SetAsRoot();
+      root = tn;
+      continue;
     }
+    if(static_cast<unsigned int>(parent) >= s) { throw 4; }
+
+    tn->SetParent(*treeNodes[parent]);
+    treeNodes[parent]->InsertChild(*tn);
   }
 
+  CountDegrees();
+
+  return;
+}
+
+void PhylogeneticTree::Tree::CopyInto(Tree &otherTree) const throw(int)
+{
+  if(&otherTree != this) { otherTree.Copy(*this); }
   return;
 }
 
 void PhylogeneticTree::Tree::DeleteLeaf(TreeIterator &i)
 {
-  if(i.node == 0 || i.node->HowManyChildren() > 0)
+  if(i.node == 0 || i.node->HowManyChildren() > 0 || i.node->GetDeleteMe())
   {
     return;
   }
@@ -263,10 +428,47 @@ void PhylogeneticTree::Tree::DeleteLeaf(TreeIterator &i)
   i.node = 0;
   i.depth = 0;
 
+  const unsigned int leafIndex = node->GetLeafIndex();
+  if(leafIndex >= leaves.size() || leaves[leafIndex].node != node)
+  {
+    leavesListed = false;
+  }
+  TreeIterator replacement;
+  --degrees[0];
+
   if(node == root) root = 0;
-  else             parent->RemoveChild(*node);
+  else
+  {
+    parent->RemoveChild(*node);
 
+    const unsigned int left = parent->HowManyChildren();
+    --degrees[left + 1];
+    ++degrees[left];
+
+    // A parent left without children is a leaf now, and comes in the same
+    //   place in the traversal as the leaf it loses.
+    if(left == 0 && leavesListed)
+    {
+      parent->SetLeafIndex(leafIndex);
+      replacement = TreeIterator(parent, leaves[leafIndex].depth - 1);
+    }
+  }
+  if(leavesListed) { leaves[leafIndex] = replacement; }
+
+  nodesDeleted = true;
   node->SetDeleteMe(true);
+  if(idIndex != 0) { idIndex.load()->Erase(node->GetId()); }
+  if(dfsIndex != 0) { dfsIndex.load()->Invalidate(); }
+
+  return;
+}
+
+void PhylogeneticTree::Tree::DeleteLeaves(vector<TreeIterator> &doomed)
+{
+  vector<TreeIterator>::iterator i = doomed.begin();
+  for(; i != doomed.end(); ++i) { DeleteLeaf(*i); }
+
+  ClearDeleted();
 
   return;
 }
@@ -295,7 +497,13 @@ void PhylogeneticTree::Tree::DeleteSingle(TreeIterator &i)
     child->SetParent(*parent);
   }
 
+  --degrees[1];
+  leavesListed = false;
+
+  nodesDeleted = true;
   node->SetDeleteMe(true);
+  if(idIndex != 0) { idIndex.load()->Erase(node->GetId()); }
+  if(dfsIndex != 0) { dfsIndex.load()->Invalidate(); }
 
   return;
 }
@@ -308,63 +516,201 @@ PhylogeneticTree::TreeIterator PhylogeneticTree::Tree::End(void) const
   return TreeIterator();
 }
 
-PhylogeneticTree::TreeIterator PhylogeneticTree::Tree::Find(const int id) const throw(int)
+void PhylogeneticTree::Tree::Extend(const OrganismTable &organisms,
+                                    const TreeBuilder &builder) throw(int)
 {
-  TreeIterator end = End();
-  for(TreeIterator i = Begin(); i != end; ++i)
+  builder.Finish();
+  if(builder.Size() != organisms.Size() || nodesDeleted ||
+     treeNodes.size() > organisms.Size())
   {
-    if(*i == 0) throw 0;
+    throw 5;
+  }
 
-    if((*i)->GetData().GetId() == id) return i;
+  // Organisms already in the tree may have died since it was built.  A
+  //   tree not built from this table has other nodes in its slots.
+  for(unsigned int r = 0; r < treeNodes.size(); ++r)
+  {
+    if(treeNodes[r]->GetId() != organisms.GetId(r)) { throw 5; }
+    treeNodes[r]->SetIsAlive(organisms.GetIsAlive(r));
   }
 
+  for(unsigned int r = static_cast<unsigned int>(treeNodes.size());
+      r < organisms.Size(); ++r)
+  {
+    // A second root can not be joined to the tree.
+    const int parent = builder.GetParentSlot(r);
+    if(parent == TreeBuilder::NoParent) { throw 4; }
+
+    TreeNode *tn = pool->Create(organisms, r);
+    if(tn == 0) { throw 1; }
+    tn->SetSlot(r);
+    treeNodes.push_back(tn);
+    if(idIndex != 0) { idIndex.load()->Insert(tn->GetId(), r); }
+
+    tn->SetParent(*treeNodes[parent]);
+    treeNodes[parent]->InsertChild(*tn);
+
+    const unsigned int children = treeNodes[parent]->HowManyChildren();
+    if(children >= degrees.size()) { degrees.resize(children + 1, 0); }
+    --degrees[children - 1];
+    ++degrees[children];
+    ++degrees[0];
+  }
+
+  leavesListed = false;
+  if(dfsIndex != 0) { dfsIndex.load()->Invalidate(); }
+
+  return;
+}
+
+PhylogeneticTree::TreeIterator PhylogeneticTree::Tree::Find(const int id) const throw(int)
+{
   // return End if the id was not found
-  return TreeIterator();
+  const unsigned int slot = Ids().Find(id);
+  if(slot == IdIndex::Missing) { return TreeIterator(); }
+
+  TreeNode *node = treeNodes[slot];
+  if(node == 0) throw 0;
+
+  // Positions already numbered give the depth for free; otherwise it is
+  //   left for the iterator to count if it is ever asked for.
+  const DfsIndex *positions = dfsIndex;
+  if(positions != 0 && positions->IsBuilt())
+  {
+    return TreeIterator(node, positions->GetDepth(positions->Enter(slot)));
+  }
+  return TreeIterator(node, TreeIterator::UnknownDepth);
+}
+
+vector<PhylogeneticTree::TreeIterator>
+PhylogeneticTree::Tree::Find(const vector<int> &ids) const throw(int)
+{
+  vector<TreeIterator> found;
+  found.reserve(ids.size());
+  for(vector<int>::const_iterator i = ids.begin(); i != ids.end(); ++i)
+  {
+    found.push_back(Find(*i));
+  }
+
+  return found;
+}
+
+const vector<unsigned int> &
+PhylogeneticTree::Tree::GetDegreeCounts(void) const
+{
+  return degrees;
 }
 
 vector<PhylogeneticTree::TreeIterator>
 PhylogeneticTree::Tree::GetLeaves(void) const throw(int)
 {
-  vector<TreeIterator> leaves;
+  if(!leavesListed) { ListLeaves(); }
 
-  TreeIterator end = End();
-  for(TreeIterator i = Begin(); i != end; ++i)
+  vector<TreeIterator> found;
+  found.reserve(HowManyLeaves());
+  vector<TreeIterator>::const_iterator i = leaves.begin();
+  for(; i != leaves.end(); ++i)
   {
-    if(*i == 0) throw 0;
-
-    if((*i)->HowManyChildren() == 0) leaves.push_back(i);
+    if(i->node != 0) found.push_back(*i);
   }
 
-  return leaves;
+  return found;
 }
 
-PhylogeneticTree::TreeIterator PhylogeneticTree::Tree::Last(void) const
+pair<unsigned int, unsigned int>
+PhylogeneticTree::Tree::GetInterval(const TreeIterator &i) const throw(int)
 {
-  // The last node is the root.
-  return TreeIterator(root, 1);
+  const DfsIndex &index = Positions();
+  const unsigned int slot = PositionSlot(i);
+
+  return make_pair(index.Enter(slot), index.Exit(slot));
 }
 
-void PhylogeneticTree::Tree::ProcessOrganisms(const vector<iOrganism*> &organisms) throw(int)
+PhylogeneticTree::TreeIterator
+PhylogeneticTree::Tree::GetPosition(const unsigned int position) const
+  throw(int)
 {
-  // Temporary map of id to index used during the linking phase
-  map<int, TreeNode*> idToNode;
+  const DfsIndex &index = Positions();
+  if(position >= index.Size()) { throw 0; }
 
-  // Create a TreeNode for each organism that was loaded and then
-  //   add it to a map that maps id to TreeNode
-  vector<iOrganism*>::const_iterator iod = organisms.end();
-  for(iod = organisms.begin(); iod != organisms.end(); ++iod)
+  return TreeIterator(index.GetNode(position), index.GetDepth(position));
+}
+
+const unsigned int PhylogeneticTree::Tree::HowManyLeaves(void) const
+{
+  return (degrees.empty()) ? 0 : degrees[0];
+}
+
+const unsigned int
+PhylogeneticTree::Tree::HowManyLeaves(const TreeIterator &i) const throw(int)
+{
+  const DfsIndex &index = Positions();
+  return index.HowManyLeaves(PositionSlot(i));
+}
+
+const unsigned int
+PhylogeneticTree::Tree::HowManyNodes(const TreeIterator &i) const throw(int)
+{
+  const DfsIndex &index = Positions();
+  const unsigned int slot = PositionSlot(i);
+
+  return index.Exit(slot) - index.Enter(slot);
+}
+
+const PhylogeneticTree::IdIndex &PhylogeneticTree::Tree::Ids(void) const
+{
+  IdIndex *index = idIndex;
+  if(index != 0) { return *index; }
+
+  // Another thread may have built it while this one waited.
+  lock_guard<mutex> guard(indexLock);
+  index = idIndex;
+  if(index != 0) { return *index; }
+
+  index = new IdIndex;
+  index->Reserve(static_cast<unsigned int>(treeNodes.size()));
+
+  // Nodes waiting in ClearDeleted are no longer in the tree.
+  for(unsigned int s = 0; s < treeNodes.size(); ++s)
   {
-    if(*iod == 0) { throw 0; }
+    if(treeNodes[s] == 0 || treeNodes[s]->GetDeleteMe()) { continue; }
+    index->Insert(treeNodes[s]->GetId(), s);
+  }
+  // Published only once it is complete.
+  idIndex = index;
 
-    TreeNode *tn = new TreeNode(**iod);
-    if(tn == 0) { throw 1; }
+  return *index;
+}
 
-    idToNode.insert(make_pair((*iod)->GetId(), tn));
+void PhylogeneticTree::Tree::ListLeaves(void) const throw(int)
+{
+  leaves.clear();
+  leaves.reserve(HowManyLeaves());
 
-    treeNodes.push_back(tn);
-    // check for error -- throw 3
+  TreeIterator end = End();
+  for(TreeIterator i = Begin(); i != end; ++i)
+  {
+    if(*i == 0) throw 0;
+
+    if(i.node->HowManyChildren() == 0)
+    {
+      i.node->SetLeafIndex(static_cast<unsigned int>(leaves.size()));
+      leaves.push_back(i);
+    }
   }
+  leavesListed = true;
+
+  return;
+}
 
+PhylogeneticTree::TreeIterator PhylogeneticTree::Tree::Last(void) const
+{
+  // The last node is the root.
+  return TreeIterator(root, 1);
+}
+
+void PhylogeneticTree::Tree::LinkNodes(const IdIndex &idToSlot) throw(int)
+{
   // Traverse all the TreeNodes and attach them to their parent by using
   //   the InsertChild method.
   vector<TreeNode*>::iterator i = treeNodes.end();
@@ -372,7 +718,7 @@ void PhylogeneticTree::Tree::ProcessOrganisms(const vector<iOrganism*> &organism
   {
     // Assuming all treeNodes are valid, otherwise the above code would have 
     //   thrown 1.
-    int parentId = (*i)->GetData().GetParentId();
+    int parentId = (*i)->GetParentId();
     if(parentId == -1)
     {
       // The root has no parent so its parent will be set to itself
@@ -382,19 +728,137 @@ void PhylogeneticTree::Tree::ProcessOrganisms(const vector<iOrganism*> &organism
     }
 
     // Look up the parent by id
-    map<int, TreeNode*>::iterator temp = idToNode.find(parentId);
-    if(temp == idToNode.end()) // Could not find parent
+    const unsigned int parentSlot = idToSlot.Find(parentId);
+    if(parentSlot == IdIndex::Missing) // Could not find parent
     {
       throw 4;
     }
 
-    // Assuming temp->second will not be 0, otherwise the above code would 
-    //   have thrown 1.
     // Set parent for current node
-    (*i)->SetParent(*(temp->second));
+    TreeNode *parent = treeNodes[parentSlot];
+    (*i)->SetParent(*parent);
 
     // Add this node as child for parent node
-    temp->second->InsertChild(**i);
+    parent->InsertChild(**i);
+  }
+
+  return;
+}
+
+const PhylogeneticTree::DfsIndex &
+PhylogeneticTree::Tree::Positions(void) const throw(int)
+{
+  DfsIndex *index = dfsIndex;
+  if(index != 0 && index->IsBuilt()) { return *index; }
+
+  // Another thread may have built it while this one waited.
+  lock_guard<mutex> guard(indexLock);
+  index = dfsIndex;
+  if(index == 0)
+  {
+    index = new DfsIndex;
+    dfsIndex = index;
+  }
+  if(!index->IsBuilt())
+  {
+    index->Build(root, static_cast<unsigned int>(treeNodes.size()));
+  }
+
+  return *index;
+}
+
+const unsigned int
+PhylogeneticTree::Tree::PositionSlot(const TreeIterator &i) const throw(int)
+{
+  if(i.node == 0 || i.node->GetDeleteMe()) { throw 0; }
+  return i.node->GetSlot();
+}
+
+void PhylogeneticTree::Tree::ProcessOrganisms(const vector<iOrganism*> &organisms) throw(int)
+{
+  // Temporary index of id to slot used during the linking phase
+  IdIndex idToSlot;
+  idToSlot.Reserve(static_cast<unsigned int>(organisms.size()));
+
+  // Create a TreeNode for each organism that was loaded and then
+  //   add it to an index that maps id to the TreeNode's slot
+  treeNodes.reserve(organisms.size());
+  vector<iOrganism*>::const_iterator iod = organisms.end();
+  for(iod = organisms.begin(); iod != organisms.end(); ++iod)
+  {
+    if(*iod == 0) { throw 0; }
+
+    TreeNode *tn = pool->Create(**iod);
+    if(tn == 0) { throw 1; }
+
+    tn->SetSlot(static_cast<unsigned int>(treeNodes.size()));
+    idToSlot.Insert((*iod)->GetId(), tn->GetSlot());
+
+    treeNodes.push_back(tn);
+  }
+
+  LinkNodes(idToSlot);
+
+  return;
+}
+
+void PhylogeneticTree::Tree::ProcessOrganisms(const OrganismTable &organisms) throw(int)
+{
+  // Temporary index of id to slot used during the linking phase
+  IdIndex idToSlot;
+  idToSlot.Reserve(organisms.Size());
+
+  // Create a TreeNode for each row of the table, which is its own
+  //   iOrganism, and then add it to an index that maps id to slot
+  treeNodes.reserve(organisms.Size());
+  for(unsigned int r = 0; r < organisms.Size(); ++r)
+  {
+    TreeNode *tn = pool->Create(organisms, r);
+    if(tn == 0) { throw 1; }
+
+    tn->SetSlot(r);
+    idToSlot.Insert(organisms.GetId(r), r);
+
+    treeNodes.push_back(tn);
+  }
+
+  LinkNodes(idToSlot);
+
+  return;
+}
+
+void PhylogeneticTree::Tree::ProcessOrganisms(const OrganismTable &organisms,
+                                              const TreeBuilder &builder) throw(int)
+{
+  builder.Finish();
+  if(builder.Size() != organisms.Size()) { throw 5; }
+
+  // Node slots are table rows, so the builder already knows every parent.
+  treeNodes.reserve(organisms.Size());
+  for(unsigned int r = 0; r < organisms.Size(); ++r)
+  {
+    TreeNode *tn = pool->Create(organisms, r);
+    if(tn == 0) { throw 1; }
+
+    tn->SetSlot(r);
+    treeNodes.push_back(tn);
+  }
+
+  // Link in row order so children are in the same order as LinkNodes
+  //   would put them.
+  for(unsigned int r = 0; r < organisms.Size(); ++r)
+  {
+    const int parent = builder.GetParentSlot(r);
+    if(parent == TreeBuilder::NoParent)
+    {
+      // The root has no parent so its parent will be set to itself
+      treeNodes[r]->SetAsRoot();
+      root = treeNodes[r];
+      continue;
+    }
+
+    treeNodes[r]->SetParent(*treeNodes[parent]);
+    treeNodes[parent]->InsertChild(*treeNodes[r]);
   }
 
   return;
@@ -409,3 +873,29 @@ const unsigned int PhylogeneticTree::Tree::Size(void) const
 {
   return static_cast<unsigned int>(treeNodes.size());
 }
+
+void PhylogeneticTree::Tree::Take(Tree &otherTree)
+{
+  // The nodes point at their pool, so the pool moves with them.
+  root = otherTree.root;
+  treeNodes.swap(otherTree.treeNodes);
+  pool = otherTree.pool;
+  idIndex = otherTree.idIndex.load();
+  leaves.swap(otherTree.leaves);
+  leavesListed = otherTree.leavesListed;
+  degrees.swap(otherTree.degrees);
+  nodesDeleted = otherTree.nodesDeleted;
+  dfsIndex = otherTree.dfsIndex.load();
+
+  otherTree.root = 0;
+  otherTree.treeNodes.clear();
+  otherTree.pool = 0;
+  otherTree.idIndex = 0;
+  otherTree.leaves.clear();
+  otherTree.leavesListed = false;
+  otherTree.degrees.clear();
+  otherTree.nodesDeleted = false;
+  otherTree.dfsIndex = 0;
+
+  return;
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PhylogeneticTree/Interface/TreeBuilder.h"
+
+using namespace std;
+
+const int PhylogeneticTree::TreeBuilder::NoParent;
+const int PhylogeneticTree::TreeBuilder::Waiting;
+
+PhylogeneticTree::TreeBuilder::TreeBuilder(void)
+{
+  return;
+}
+
+PhylogeneticTree::TreeBuilder::~TreeBuilder(void)
+{
+  return;
+}
+
+void PhylogeneticTree::TreeBuilder::Add(const int id, const int parentId)
+{
+  const unsigned int slot = static_cast<unsigned int>(parentSlots.size());
+  parentSlots.push_back(Waiting);
+
+  // The first organism with an id keeps it; any later one is a duplicate.
+  if(!idToSlot.Insert(id, slot))
+  {
+    duplicateIds.insert(id);
+  }
+  else
+  {
+    // Link the children that arrived before this organism.
+    unordered_map<int, vector<unsigned int> >::iterator w = waiting.find(id);
+    if(w != waiting.end())
+    {
+      vector<unsigned int>::const_iterator c = w->second.begin();
+      for(; c != w->second.end(); ++c) { parentSlots[*c] = slot; }
+      waiting.erase(w);
+    }
+  }
+
+  if(parentId == -1)
+  {
+    parentSlots[slot] = NoParent;
+    return;
+  }
+
+  const unsigned int p = idToSlot.Find(parentId);
+  if(p != IdIndex::Missing) { parentSlots[slot] = static_cast<int>(p); }
+  else                      { waiting[parentId].push_back(slot); }
+
+  return;
+}
+
+void PhylogeneticTree::TreeBuilder::Clear(void)
+{
+  // swap with empty containers to release the memory as well
+  idToSlot.Clear();
+  vector<int>().swap(parentSlots);
+  unordered_map<int, vector<unsigned int> >().swap(waiting);
+  duplicateIds.clear();
+
+  return;
+}
+
+void PhylogeneticTree::TreeBuilder::Reserve(const unsigned int size)
+{
+  idToSlot.Reserve(size);
+  parentSlots.reserve(size);
+
+  return;
+}
+
+const unsigned int PhylogeneticTree::TreeBuilder::Size(void) const
+{
+  return static_cast<unsigned int>(parentSlots.size());
+}
+
+void PhylogeneticTree::TreeBuilder::Finish(void) const throw(int)
+{
+  if(!waiting.empty()) { throw 4; }
+  return;
+}
+
+const int PhylogeneticTree::TreeBuilder::FindSlot(const int id) const
+{
+  const unsigned int slot = idToSlot.Find(id);
+  return (slot == IdIndex::Missing) ? -1 : static_cast<int>(slot);
+}
+
+const set<int> &PhylogeneticTree::TreeBuilder::GetDuplicateIds(void) const
+{
+  return duplicateIds;
+}
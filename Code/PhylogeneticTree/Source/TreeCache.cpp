@@ -0,0 +1,272 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+#include "PhylogeneticTree/Interface/TreeCache.h"
+
+#include "PhylogeneticTree/Interface/Tree.h"
+#include "PhylogeneticTree/Interface/TreeIterator.h"
+#include "PhylogeneticTree/Interface/iTreeNode.h"
+#include "PhylogeneticTree/Interface/iOrganism.h"
+#include "PhylogeneticTree/Interface/OrganismTable.h"
+#include "Support/Interface/MappedFile.h"
+
+using namespace PhylogeneticTree;
+using namespace std;
+
+// Every section of the file is a multiple of eight bytes long so that the
+//   arrays are properly aligned when the file is mapped.
+static const char     cacheMagic[8] = { 'T','L','T','R','E','E','\0','\0' };
+static const uint32_t cacheVersion  = 1;
+
+struct CacheHeader
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t nodeCount;
+  int64_t  options;
+  uint32_t inputCount;
+  uint32_t reserved;
+};
+
+struct CacheInput
+{
+  uint64_t size;
+  int64_t  modified;
+  uint64_t hash;
+};
+
+const vector<CacheInput> FingerprintInputs(const vector<const char*> &)
+  throw(int);
+const uint64_t HashBytes(const char * const begin, const char * const end);
+const size_t   PaddedSize(const size_t);
+
+void PhylogeneticTree::SaveTreeCache(const Tree &tree,
+                                     const char * const cacheFilename,
+                                     const vector<const char*> &inputFilenames,
+                                     const long long options) throw(int)
+{
+  if(cacheFilename == 0) { throw 2; }
+
+  const vector<CacheInput> inputs = FingerprintInputs(inputFilenames);
+
+  // Flatten the tree in preorder so that every parent comes before its
+  //   children and the children keep their order.
+  vector<int32_t> ids;
+  vector<int32_t> parents;
+  vector<double>  birthTimes;
+  vector<uint8_t> alive;
+  ids.reserve(tree.Size());
+  parents.reserve(tree.Size());
+  birthTimes.reserve(tree.Size());
+  alive.reserve(tree.Size());
+
+  if(tree.Size() > 0 && *tree.Root() != 0)
+  {
+    vector<pair<TreeIterator, int32_t> > pending;
+    pending.push_back(make_pair(tree.Root(), static_cast<int32_t>(-1)));
+    while(!pending.empty())
+    {
+      const TreeIterator node = pending.back().first;
+      const int32_t parent = pending.back().second;
+      pending.pop_back();
+
+      const iTreeNode &treeNode = **node;
+      const int32_t index = static_cast<int32_t>(ids.size());
+      ids.push_back(treeNode.GetId());
+      parents.push_back(parent);
+      birthTimes.push_back(treeNode.GetBirthTime());
+      alive.push_back((treeNode.GetIsAlive()) ? 1 : 0);
+
+      // Pushed in reverse so that the first child is visited first.
+      const ChildRange children = node.Children();
+      for(size_t i = children.Size(); i > 0; --i)
+      {
+        pending.push_back(make_pair(children[i-1], index));
+      }
+    }
+  }
+
+  CacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+  header.version    = cacheVersion;
+  header.nodeCount  = static_cast<uint32_t>(ids.size());
+  header.options    = options;
+  header.inputCount = static_cast<uint32_t>(inputs.size());
+
+  const string temporaryFilename = string(cacheFilename) + ".tmp";
+  ofstream out(temporaryFilename.c_str(), ios::out | ios::binary);
+  if(!out) { throw 2; }
+
+  const char padding[8] = { 0 };
+  const size_t n = ids.size();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if(!inputs.empty())
+  {
+    out.write(reinterpret_cast<const char*>(&inputs[0]),
+              inputs.size() * sizeof(CacheInput));
+  }
+  if(n > 0)
+  {
+    out.write(reinterpret_cast<const char*>(&ids[0]), n * sizeof(int32_t));
+    out.write(padding, PaddedSize(n * sizeof(int32_t)) - n * sizeof(int32_t));
+    out.write(reinterpret_cast<const char*>(&parents[0]), n * sizeof(int32_t));
+    out.write(padding, PaddedSize(n * sizeof(int32_t)) - n * sizeof(int32_t));
+    out.write(reinterpret_cast<const char*>(&birthTimes[0]),
+              n * sizeof(double));
+    out.write(reinterpret_cast<const char*>(&alive[0]), n);
+    out.write(padding, PaddedSize(n) - n);
+  }
+  out.close();
+
+  if(!out || rename(temporaryFilename.c_str(), cacheFilename) != 0)
+  {
+    remove(temporaryFilename.c_str());
+    throw 2;
+  }
+
+  return;
+}
+
+const bool PhylogeneticTree::LoadTreeCache(OrganismTable &organisms,
+                                           const char * const cacheFilename,
+                                           const vector<const char*> &inputFilenames,
+                                           const long long options) throw(int)
+{
+  if(cacheFilename == 0) { return false; }
+
+  MappedFile cache;
+  try { cache.Open(cacheFilename); }
+  catch(int) { return false; }
+
+  // Anything that is not a cache for these inputs is simply not used.
+  CacheHeader header;
+  if(cache.Size() < sizeof(header)) { return false; }
+  memcpy(&header, cache.Begin(), sizeof(header));
+  if(memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+     header.version != cacheVersion ||
+     header.options != options ||
+     header.inputCount != inputFilenames.size())
+  {
+    return false;
+  }
+
+  const size_t n = header.nodeCount;
+  const size_t inputBytes = header.inputCount * sizeof(CacheInput);
+  const size_t expectedSize = sizeof(header) + inputBytes +
+                              2 * PaddedSize(n * sizeof(int32_t)) +
+                              n * sizeof(double) + PaddedSize(n);
+  if(cache.Size() != expectedSize) { return false; }
+
+  // Checked last since hashing reads every input file.
+  const vector<CacheInput> inputs = FingerprintInputs(inputFilenames);
+  if(!inputs.empty() &&
+     memcmp(&inputs[0], cache.Begin() + sizeof(header), inputBytes) != 0)
+  {
+    return false;
+  }
+
+  const char *pos = cache.Begin() + sizeof(header) + inputBytes;
+  const int32_t *ids = reinterpret_cast<const int32_t*>(pos);
+  pos += PaddedSize(n * sizeof(int32_t));
+  const int32_t *parents = reinterpret_cast<const int32_t*>(pos);
+  pos += PaddedSize(n * sizeof(int32_t));
+  const double *birthTimes = reinterpret_cast<const double*>(pos);
+  pos += n * sizeof(double);
+  const uint8_t *alive = reinterpret_cast<const uint8_t*>(pos);
+
+  // In preorder every parent is already known, and only the root has none.
+  for(size_t i = 0; i < n; ++i)
+  {
+    if((i == 0) != (parents[i] < 0) ||
+       parents[i] >= static_cast<int32_t>(i))
+    {
+      throw 2;
+    }
+  }
+
+  organisms.Reserve(organisms.Size() + static_cast<unsigned int>(n));
+  for(size_t i = 0; i < n; ++i)
+  {
+    const int parentId = (parents[i] < 0) ? -1 : ids[parents[i]];
+    organisms.Append(ids[i], parentId, birthTimes[i], alive[i] != 0);
+  }
+
+  return true;
+}
+
+const vector<CacheInput> FingerprintInputs(const vector<const char*> &filenames)
+  throw(int)
+{
+  vector<CacheInput> inputs;
+
+  vector<const char*>::const_iterator i = filenames.begin();
+  for(; i != filenames.end(); ++i)
+  {
+    if(*i == 0) { throw 1; }
+
+    struct stat info;
+    if(stat(*i, &info) != 0) { throw 1; }
+
+    MappedFile file;
+    try { file.Open(*i); }
+    catch(int) { throw 1; }
+
+    CacheInput input;
+    memset(&input, 0, sizeof(input));
+    input.size     = static_cast<uint64_t>(file.Size());
+    input.modified = static_cast<int64_t>(info.st_mtime);
+    input.hash     = HashBytes(file.Begin(), file.End());
+    inputs.push_back(input);
+  }
+
+  return inputs;
+}
+
+const uint64_t HashBytes(const char * const begin, const char * const end)
+{
+  // FNV-1a style mixing, but over eight bytes at a time so that hashing
+  //   keeps up with reading the file.  Not meant to resist tampering.
+  const uint64_t prime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  const char *pos = begin;
+  for(; end - pos >= 8; pos += 8)
+  {
+    uint64_t word;
+    memcpy(&word, pos, sizeof(word));
+    hash = (hash ^ word) * prime;
+    hash ^= hash >> 32;
+  }
+  for(; pos != end; ++pos)
+  {
+    hash = (hash ^ static_cast<unsigned char>(*pos)) * prime;
+  }
+
+  return hash ^ static_cast<uint64_t>(end - begin);
+}
+
+const size_t PaddedSize(const size_t size)
+{
+  return (size + 7) & ~static_cast<size_t>(7);
+}
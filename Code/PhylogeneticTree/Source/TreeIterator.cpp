@@ -39,9 +39,19 @@ PhylogeneticTree::TreeIterator::~TreeIterator(void)
   return;
 }
 
+void PhylogeneticTree::TreeIterator::CountDepth(void) const
+{
+  // The root is at depth 1.
+  depth = 0;
+  for(const TreeNode *up = node; up != 0; up = up->GetParent()) { ++depth; }
+
+  return;
+}
+
 void PhylogeneticTree::TreeIterator::Next_Depth(void)
 {
   if(node == 0) { return; }
+  GetDepth();
 
   TreeNode *currentNode = node;
 
@@ -55,30 +65,16 @@ void PhylogeneticTree::TreeIterator::Next_Depth(void)
 
   // 3. If the node we just left was last in the list of children for this
   //      this node, stop.
-  if(node->GetChildren().back() == currentNode)
+  const TreeNode::ChildList &children = node->GetChildren();
+  const unsigned int i = currentNode->GetChildIndex();
+  if(i + 1 >= children.size())
   {
     return;
   }
 
   // 4. Else goto next child in the list and all the way down to the left
-  const vector<TreeNode*> &children = node->GetChildren();
-  vector<TreeNode*>::const_iterator i = children.end();
-  for(i = children.begin(); i != children.end(); ++i)
-  {
-    if(*i == currentNode)
-    {
-      ++i;
-      node = *i;
-      ++depth;
-      break;
-    }
-  }
-  if(i == children.end() || node == 0)
-  {
-    node = 0;
-    depth = 0;
-    return;
-  }
+  node = children[i + 1];
+  ++depth;
 
   // Traverse down the tree as far to the left as possible from node.  I 
   //   assume there are no cycles in the tree.
@@ -150,6 +146,7 @@ PhylogeneticTree::TreeIterator::operator=(const TreeIterator &t)
 void PhylogeneticTree::TreeIterator::Previous_Depth(void)
 {
   if(node == 0) { return; }
+  GetDepth();
 
   // 1. If the node is not a leaf, go to last child
   if(node->HowManyChildren() > 0)
@@ -179,25 +176,9 @@ void PhylogeneticTree::TreeIterator::Previous_Depth(void)
   while(node->GetChildren().front() == currentNode);
 
   // 4. Once we reach a parent where the previous node was not first in the 
-  //      list of children.  Find the previous child and go to that node.
-  const vector<TreeNode*> &children = node->GetChildren();
-  vector<TreeNode*>::const_iterator i = children.end();
-  for(i = children.begin(); i != children.end(); ++i)
-  {
-    if(*i == currentNode)
-    {
-      --i;
-      node = *i;
-      ++depth;
-      break;
-    }
-  }
-  if(i == children.end() || node == 0)
-  {
-    node = 0;
-    depth = 0;
-    return;
-  }
+  //      list of children.  Go to the previous child.
+  node = node->GetChildren()[currentNode->GetChildIndex() - 1];
+  ++depth;
 
   return;
 }
@@ -205,6 +186,7 @@ void PhylogeneticTree::TreeIterator::Previous_Depth(void)
 void PhylogeneticTree::TreeIterator::Up(void)
 {
   if(node == 0) { return; }
+  GetDepth();
   node = node->GetParent();
   --depth;
   return;
@@ -213,7 +195,7 @@ PhylogeneticTree::TreeIterator
 PhylogeneticTree::TreeIterator::GetParent(void) const
 {
   if(node == 0) { return TreeIterator(0,0); }
-  return TreeIterator(node->GetParent(), depth - 1);
+  return TreeIterator(node->GetParent(), GetDepth() - 1);
 }
 
 vector<PhylogeneticTree::TreeIterator>
@@ -224,11 +206,155 @@ PhylogeneticTree::TreeIterator::GetChildren(void) const
   // return empty list if there are no children
   if(node == 0) return children;
 
-  const vector<TreeNode*> &childNodes = node->GetChildren();
-  vector<TreeNode*>::const_iterator i = childNodes.begin();
+  const int childDepth = GetDepth() + 1;
+  const TreeNode::ChildList &childNodes = node->GetChildren();
+  TreeNode::ChildList::const_iterator i = childNodes.begin();
   for(; i != childNodes.end(); ++i)
-    children.push_back(TreeIterator(*i, depth+1));
+    children.push_back(TreeIterator(*i, childDepth));
 
   return children;
 }
 
+PhylogeneticTree::ChildRange
+PhylogeneticTree::TreeIterator::Children(void) const
+{
+  if(node == 0 || node->HowManyChildren() == 0)
+  {
+    return ChildRange(0, 0, GetDepth()+1);
+  }
+
+  const TreeNode::ChildList &childNodes = node->GetChildren();
+  return ChildRange(childNodes.data(), childNodes.data() + childNodes.size(),
+                    GetDepth()+1);
+}
+
+
+PhylogeneticTree::ChildRange::const_iterator::const_iterator(
+  TreeNode * const *c, const int _depth)
+: child(c), depth(_depth)
+{
+  return;
+}
+
+PhylogeneticTree::TreeIterator
+PhylogeneticTree::ChildRange::const_iterator::operator*(void) const
+{
+  return TreeIterator(*child, depth);
+}
+
+void PhylogeneticTree::ChildRange::const_iterator::operator++(void)
+{
+  ++child;
+  return;
+}
+
+const bool PhylogeneticTree::ChildRange::const_iterator::operator==(
+  const const_iterator &other) const
+{
+  return child == other.child;
+}
+
+const bool PhylogeneticTree::ChildRange::const_iterator::operator!=(
+  const const_iterator &other) const
+{
+  return child != other.child;
+}
+
+PhylogeneticTree::ChildRange::ChildRange(TreeNode * const *f,
+                                         TreeNode * const *l,
+                                         const int _depth)
+: first(f), last(l), depth(_depth)
+{
+  return;
+}
+
+PhylogeneticTree::ChildRange::const_iterator
+PhylogeneticTree::ChildRange::begin(void) const
+{
+  return const_iterator(first, depth);
+}
+
+PhylogeneticTree::ChildRange::const_iterator
+PhylogeneticTree::ChildRange::end(void) const
+{
+  return const_iterator(last, depth);
+}
+
+const size_t PhylogeneticTree::ChildRange::Size(void) const
+{
+  return static_cast<size_t>(last - first);
+}
+
+PhylogeneticTree::TreeIterator
+PhylogeneticTree::ChildRange::operator[](const size_t i) const
+{
+  return TreeIterator(first[i], depth);
+}
+
+PhylogeneticTree::LevelIterator::LevelIterator(void)
+: current(0), levelEnd(0), depth(0)
+{
+  return;
+}
+
+PhylogeneticTree::LevelIterator::LevelIterator(const TreeIterator &start)
+: current(0), levelEnd(0), depth(0)
+{
+  Reset(start);
+  return;
+}
+
+PhylogeneticTree::LevelIterator::~LevelIterator(void)
+{
+  return;
+}
+
+void PhylogeneticTree::LevelIterator::Reset(const TreeIterator &start)
+{
+  // clear keeps the capacity from the last traversal
+  buffer.clear();
+  current = 0;
+  depth = start.GetDepth();
+
+  if(start.node != 0) { buffer.push_back(start.node); }
+  levelEnd = buffer.size();
+
+  return;
+}
+
+void PhylogeneticTree::LevelIterator::operator++(void)
+{
+  if(Done()) { return; }
+
+  // Queue the children of the node being left.  Visited nodes stay in the
+  //   buffer, so it ends up holding the whole subtree.
+  const TreeNode::ChildList &children = buffer[current]->GetChildren();
+  buffer.insert(buffer.end(), children.begin(), children.end());
+
+  ++current;
+  if(current == levelEnd)
+  {
+    levelEnd = buffer.size();
+    ++depth;
+  }
+
+  return;
+}
+
+const bool PhylogeneticTree::LevelIterator::Done(void) const
+{
+  return current >= buffer.size();
+}
+
+const PhylogeneticTree::iTreeNode *
+PhylogeneticTree::LevelIterator::operator*(void) const
+{
+  if(Done()) { return 0; }
+  return buffer[current];
+}
+
+PhylogeneticTree::TreeIterator PhylogeneticTree::LevelIterator::Get(void) const
+{
+  if(Done()) { return TreeIterator(0, 0); }
+  return TreeIterator(buffer[current], depth);
+}
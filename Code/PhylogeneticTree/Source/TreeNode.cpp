@@ -16,13 +16,65 @@
 
 #include "PhylogeneticTree/Include/TreeNode.h"
 
-#include "PhylogeneticTree/Interface/iOrganism.h"
+#include "PhylogeneticTree/Interface/OrganismTable.h"
 
 using namespace std;
 
-PhylogeneticTree::TreeNode::TreeNode(const iOrganism &od)
-: data(const_cast<iOrganism&>(od)), parent(0), deleteMe(false)
+const int PhylogeneticTree::RowOrganism::GetId(void) const
 {
+  return static_cast<const TreeNode*>(this)->GetId();
+}
+
+const int PhylogeneticTree::RowOrganism::GetParentId(void) const
+{
+  return static_cast<const TreeNode*>(this)->GetParentId();
+}
+
+const double PhylogeneticTree::RowOrganism::GetBirthTime(void) const
+{
+  return static_cast<const TreeNode*>(this)->GetBirthTime();
+}
+
+const bool PhylogeneticTree::RowOrganism::GetIsAlive(void) const
+{
+  return static_cast<const TreeNode*>(this)->GetIsAlive();
+}
+
+PhylogeneticTree::TreeNode::TreeNode(const iOrganism &od, NodePool &pool)
+: deleteMe(false), slot(0), organism(&od), parent(0),
+  children(PoolAllocator<TreeNode*>(pool)), childIndex(0), leafIndex(0)
+{
+  birthTime = od.GetBirthTime();
+  id        = od.GetId();
+  parentId  = od.GetParentId();
+  isAlive   = od.GetIsAlive();
+  return;
+}
+
+PhylogeneticTree::TreeNode::TreeNode(const OrganismTable &organisms,
+                                     const unsigned int r, NodePool &pool)
+: deleteMe(false), slot(0), organism(this), parent(0),
+  children(PoolAllocator<TreeNode*>(pool)), childIndex(0), leafIndex(0)
+{
+  birthTime = organisms.GetBirthTime(r);
+  id        = organisms.GetId(r);
+  parentId  = organisms.GetParentId(r);
+  isAlive   = organisms.GetIsAlive(r);
+  return;
+}
+
+PhylogeneticTree::TreeNode::TreeNode(const TreeNode &other, NodePool &pool)
+: deleteMe(false), slot(0), organism(other.organism), parent(0),
+  children(PoolAllocator<TreeNode*>(pool)), childIndex(0), leafIndex(0)
+{
+  birthTime = other.birthTime;
+  id        = other.id;
+  parentId  = other.parentId;
+  isAlive   = other.isAlive;
+
+  // A copy of a node made from a row stands for the row itself.
+  if(organism == static_cast<const iOrganism*>(&other)) { organism = this; }
+
   return;
 }
 
@@ -37,21 +89,32 @@ PhylogeneticTree::TreeNode::~TreeNode(void)
 void PhylogeneticTree::TreeNode::ChangeChild(const TreeNode &from,
                                              const TreeNode &to)
 {
-  vector<TreeNode*>::iterator iNode = children.end();
-
-  for(iNode = children.begin(); iNode != children.end(); ++iNode)
+  const size_t i = FindChild(from);
+  if(i < children.size())
   {
-    if(*iNode == &from)
-    {
-      *iNode = const_cast<TreeNode*>(&to);
-      break;
-    }
+    children[i] = const_cast<TreeNode*>(&to);
+    children[i]->childIndex = static_cast<unsigned int>(i);
   }
 
   return;
 }
 
-const vector<PhylogeneticTree::TreeNode*> &
+const size_t PhylogeneticTree::TreeNode::FindChild(const TreeNode &node) const
+{
+  // A child always knows its position, so a node that is not at its own
+  //   position is not a child.
+  const size_t i = node.childIndex;
+  if(i < children.size() && children[i] == &node) { return i; }
+
+  return children.size();
+}
+
+const unsigned int PhylogeneticTree::TreeNode::GetChildIndex(void) const
+{
+  return childIndex;
+}
+
+const PhylogeneticTree::TreeNode::ChildList &
 PhylogeneticTree::TreeNode::GetChildren(void) const
 {
   return children;
@@ -60,8 +123,8 @@ PhylogeneticTree::TreeNode::GetChildren(void) const
 const PhylogeneticTree::iOrganism &
 PhylogeneticTree::TreeNode::GetData(void) const
 {
-  // Assuming data is always valid due to the way it is set.
-  return data;
+  // Assuming the organism is always valid due to the way it is set.
+  return *organism;
 }
 
 const bool PhylogeneticTree::TreeNode::GetDeleteMe(void) const
@@ -69,11 +132,21 @@ const bool PhylogeneticTree::TreeNode::GetDeleteMe(void) const
   return deleteMe;
 }
 
+const unsigned int PhylogeneticTree::TreeNode::GetLeafIndex(void) const
+{
+  return leafIndex;
+}
+
 PhylogeneticTree::TreeNode *PhylogeneticTree::TreeNode::GetParent(void) const
 {
   return parent;
 }
 
+const unsigned int PhylogeneticTree::TreeNode::GetSlot(void) const
+{
+  return slot;
+}
+
 const unsigned int PhylogeneticTree::TreeNode::HowManyChildren(void) const
 {
   return static_cast<unsigned int>(children.size());
@@ -81,41 +154,44 @@ const unsigned int PhylogeneticTree::TreeNode::HowManyChildren(void) const
 
 void PhylogeneticTree::TreeNode::InsertChild(const TreeNode &node) throw(int)
 {
-  vector<TreeNode*>::iterator iNode = children.end();
-
-  for(iNode = children.begin(); iNode != children.end(); ++iNode)
+  if(FindChild(node) < children.size())
   {
-    if(&node == *iNode)
-    {
-      throw 0;
-    }
+    throw 0;
   }
   if(&node == parent)
   {
     throw 1;
   }
 
-  children.push_back(const_cast<TreeNode*>(&node));
+  TreeNode *child = const_cast<TreeNode*>(&node);
+  child->childIndex = static_cast<unsigned int>(children.size());
+  children.push_back(child);
 
   return;
 }
 
 void PhylogeneticTree::TreeNode::RemoveChild(const TreeNode &node)
 {
-  vector<TreeNode*>::iterator iNode = children.end();
+  const size_t i = FindChild(node);
+  if(i >= children.size()) { return; }
+
+  children.erase(children.begin() + i);
 
-  for(iNode = children.begin(); iNode != children.end(); ++iNode)
+  // The children after it each move up one position.
+  for(size_t j = i; j < children.size(); ++j)
   {
-    if(*iNode == &node)
-    {
-      children.erase(iNode);
-      break;
-    }
+    children[j]->childIndex = static_cast<unsigned int>(j);
   }
 
   return;
 }
 
+void PhylogeneticTree::TreeNode::ReserveChildren(const unsigned int n)
+{
+  children.reserve(n);
+  return;
+}
+
 void PhylogeneticTree::TreeNode::SetAsRoot(void)
 {
   parent = 0;
@@ -128,8 +204,26 @@ void PhylogeneticTree::TreeNode::SetDeleteMe(const bool b)
     return;
 }
 
+void PhylogeneticTree::TreeNode::SetIsAlive(const bool b)
+{
+  isAlive = b;
+  return;
+}
+
+void PhylogeneticTree::TreeNode::SetLeafIndex(const unsigned int i)
+{
+  leafIndex = i;
+  return;
+}
+
 void PhylogeneticTree::TreeNode::SetParent(const TreeNode &parentNode)
 {
   parent = const_cast<TreeNode*>(&parentNode);
   return;
 }
+
+void PhylogeneticTree::TreeNode::SetSlot(const unsigned int s)
+{
+  slot = s;
+  return;
+}
@@ -40,6 +40,27 @@ void PhylogeneticTree::BurnLeaf(Tree &tree, TreeIterator &it)
   return;
 }
 
+void PhylogeneticTree::BurnLeaves(Tree &tree, vector<TreeIterator> &leaves)
+{
+  // Deleted nodes stay where they are until ClearDeleted, so the other
+  //   iterators in the list remain valid while each lineage is burned.
+  vector<TreeIterator>::iterator leaf = leaves.begin();
+  for(; leaf != leaves.end(); ++leaf)
+  {
+    TreeIterator &it = *leaf;
+    while(it != tree.End() && (*it)->HowManyChildren() == 0)
+    {
+      TreeIterator temp = it;
+      it.Up(); // Move to parent
+      tree.DeleteLeaf(temp);
+    }
+  }
+
+  tree.ClearDeleted();
+
+  return;
+}
+
 const bool PhylogeneticTree::CyclesFound(const Tree &)
 {
   return false;
@@ -50,15 +71,14 @@ const bool PhylogeneticTree::PrintInformation(const Tree &tree,
 {
   int leaves=0, singles=0, doubles=0, others=0;
 
-  TreeIterator it = tree.End();
-  for(it = tree.Begin(); it != tree.End(); ++it)
+  // The tree keeps count of its nodes by how many children they have.
+  const vector<unsigned int> &degrees = tree.GetDegreeCounts();
+  for(unsigned int children = 0; children < degrees.size(); ++children)
   {
-    if(*it == 0) { return false; }
-
-    if((*it)->HowManyChildren() == 0)      { ++leaves;  }
-    else if((*it)->HowManyChildren() == 1) { ++singles; }
-    else if((*it)->HowManyChildren() == 2) { ++doubles; }
-    else                                   { ++others;  }
+    if(children == 0)      { leaves  += degrees[children]; }
+    else if(children == 1) { singles += degrees[children]; }
+    else if(children == 2) { doubles += degrees[children]; }
+    else                   { others  += degrees[children]; }
   }
 
   o << "Leaf         node count: " << leaves << endl;
@@ -77,15 +97,18 @@ const bool PhylogeneticTree::PruneDeadLeaves(Tree &tree)
   try
   {
     vector<TreeIterator> leaves = tree.GetLeaves();
+    vector<TreeIterator> dead;
 
     vector<TreeIterator>::iterator i = leaves.end();
     for(i = leaves.begin(); i != leaves.end(); ++i)
     {
-      if((**i)->GetData().GetIsAlive() == false)
+      if((**i)->GetIsAlive() == false)
       {
-        BurnLeaf(tree, *i);
+        dead.push_back(*i);
       }
     }
+
+    BurnLeaves(tree, dead);
   }
   catch(int) { return false; }
 
@@ -113,17 +136,27 @@ void PhylogeneticTree::RemoveNonfurcatingNodes(Tree &tree)
   return;
 }
 
-PhylogeneticTree::Tree *PhylogeneticTree::Sample(const Tree &tree,
-                                                 const unsigned int howManyLeaves,
-                                                 RandomNumberGenerator &rng)
-  throw(int)
+unique_ptr<PhylogeneticTree::Tree>
+PhylogeneticTree::Sample(const Tree &tree,
+                         const unsigned int howManyLeaves,
+                         RandomNumberGenerator &rng) throw(int)
+{
+  unique_ptr<Tree> newTree(new Tree);
+  Sample(tree, howManyLeaves, rng, *newTree);
+
+  return newTree;
+}
+
+void PhylogeneticTree::Sample(const Tree &tree,
+                              const unsigned int howManyLeaves,
+                              RandomNumberGenerator &rng,
+                              Tree &newTree) throw(int)
 {
   /*** Copy orignal tree ****************************************************/
-  Tree *newTree = new Tree(tree);
-  if(newTree == 0) { return 0; }
+  tree.CopyInto(newTree);
 
   /*** Find all the leaves **************************************************/
-  vector<TreeIterator> leaves = newTree->GetLeaves();
+  vector<TreeIterator> leaves = newTree.GetLeaves();
 
   /*** Get an inverse sample of the leaves **********************************/
   unsigned int inverseSize = static_cast<unsigned int>(leaves.size());
@@ -143,13 +176,9 @@ PhylogeneticTree::Tree *PhylogeneticTree::Sample(const Tree &tree,
   }
 
   /*** Burn away all the other leaves ***************************************/
-  vector<TreeIterator>::iterator iSample = inverseSample.end();
-  for(iSample = inverseSample.begin(); iSample != inverseSample.end(); ++iSample)
-  {
-    BurnLeaf(*newTree, *iSample);
-  }
+  BurnLeaves(newTree, inverseSample);
 
-  return newTree;
+  return;
 }
 
 const bool PhylogeneticTree::Validate(const Tree &)
@@ -20,53 +20,179 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "ProgramInterface.h"
 
 #include "PhylogeneticTree/Interface/Tree.h"
+#include "PhylogeneticTree/Interface/FlatTree.h"
 #include "PhylogeneticTree/Interface/iTreeNode.h"
 #include "PhylogeneticTree/Interface/Utilities.h"
 #include "PhylogeneticTree/Interface/GammaFunctions.h"
 #include "PhylogeneticTree/Interface/NoncumulativeStem.h"
 #include "PhylogeneticTree/Interface/Balance.h"
 #include "PhylogeneticTree/Interface/NewickOutput.h"
+#include "PhylogeneticTree/Interface/SubtreeSampler.h"
+#include "PhylogeneticTree/Interface/TreeBuilder.h"
+#include "PhylogeneticTree/Interface/TreeCache.h"
 #include "Organisms/Interface/Avida.h"
+#include "Support/Interface/CompressedFile.h"
+#include "Support/Interface/MappedFile.h"
 #include "Support/Interface/OutputStream.h"
 #include "Support/Interface/random.h"
+#include "Support/Interface/ThreadPool.h"
 
 using namespace std;
 using namespace PhylogeneticTree;
 
+/*** Helper Types ***********************************************************/
+// One input file, read by whichever reader suits it.  Compressed files are
+//   decompressed on a read-ahead thread and parsed as a stream; other files
+//   are mapped into memory when asked to, or read as plain streams.
+struct InputFile
+{
+  ifstream       stream;
+  MappedFile     map;
+  CompressedFile compressed;
+  istream        decompressed;
+  bool           isCompressed;
+  bool           isMapped;
+  // Bytes of a mapped file to load.
+  size_t         length;
+
+  InputFile(void)
+    : decompressed(&compressed), isCompressed(false), isMapped(false),
+      length(0)
+  { return; }
+};
+
+// A record appended to a followed historic file whose parent has not been
+//   seen yet.
+struct PendingOrganism
+{
+  int    id;
+  int    parentId;
+  double birthTime;
+  bool   isAlive;
+};
+typedef unordered_map<int, vector<PendingOrganism> > PendingOrganisms;
+
+// A metric computed on every sample, and where its results go.
+struct SampleMetric
+{
+  int      method; // 1 == gamma, 2 == NCStem, 3 == Balance
+  double   trueValue;
+  ostream *reportTxt;
+  ostream *reportCsv;
+  ostream *listTxt;
+  ostream *listCsv;
+};
+
+// What one metric writes for one sample replicate.
+struct MetricOutput
+{
+  ostringstream reportTxt;
+  ostringstream reportCsv;
+  ostringstream listTxt;
+  ostringstream listCsv;
+  double        value;
+  bool          failed;
+
+  MetricOutput(void) : value(0), failed(false) { return; }
+};
+
+// What one sample replicate writes, one MetricOutput per metric.  It is held
+//   until the replicates before it have been written, so output comes in
+//   replicate order whichever thread ran it.
+struct SampleOutput
+{
+  ostringstream        console;
+  vector<MetricOutput> metrics;
+
+  SampleOutput(const size_t metricCount) : metrics(metricCount) { return; }
+};
+
 /*** Helper Functions *******************************************************/
 // Set detailFilename to zero if you want no file output for specific calc.
-const double CalculateGamma(const Tree &, const char * const detailFilename,
-                            const double timeCutoff);
-const double CalculateNCStem(const Tree &, const char * const detailFilename,
-                             const double timeCutoff);
-const double CalculateBalance(const Tree &,
+const double CalculateGamma(const FlatTree &,
+                            const char * const detailFilename,
+                            const double timeCutoff,
+                            OutputStream &);
+const double CalculateNCStem(const FlatTree &,
+                             const char * const detailFilename,
+                             const double timeCutoff,
+                             OutputStream &);
+const double CalculateBalance(const FlatTree &,
                               const bool generateReport,
                               ostream &reportTxt, ostream &reportCsv,
-                              ostream &listTxt, ostream &listCsv);
-void Cleanup(Tree **, vector<iOrganism*> &);
+                              ostream &listTxt, ostream &listCsv,
+                              OutputStream &);
+const unsigned int AddFollowed(OrganismTable &organisms,
+                               const TreeBuilder &builder,
+                               const OrganismTable &appended,
+                               PendingOrganisms &pending,
+                               unsigned int &pendingCount);
+void Cleanup(Tree **, AvidaOrganismTable &);
 void CreateOutput(const char *const detailFilename, const char *const extension,
                   ofstream &, ofstream &);
-void LoadOrganisms(vector<iOrganism*> &organisms,
+void LoadOrganisms(AvidaOrganismTable &organisms,
                    const char * const historicFilename,
-                   const char * const detailFilename);
-void PrepareTree(Tree &);
-const double RunSamples(const Tree &, unsigned int samples,
-                        unsigned int leavesToSample,
-                        const double trueValue,
-                        const double timeCutoff,
-                        const int method,
-                        const bool generateReport,
-                        const bool generateNewick,
-                        ostream &reportTxt,
-                        ostream &reportCsv,
-                        ostream &listTxt,
-                        ostream &listCsv,
-                        const char * const newickFilenameBase,
-                        const char * const outFilename);
+                   const char * const detailFilename,
+                   const bool useMappedFiles,
+                   ThreadPool &,
+                   size_t *historicLoaded);
+void Follow(AvidaOrganismTable &organisms, TreeBuilder &builder,
+            Tree &growingTree,
+            const char * const historicFilename,
+            const char * const detailFilename,
+            size_t offset,
+            const unsigned int seconds,
+            const unsigned int refreshes,
+            const bool generateReport,
+            const bool calcGamma,
+            const bool calcNCStem,
+            const bool calcBalance,
+            const double timeCutoff);
+const double StreamSize(istream &);
+const bool OpenInput(InputFile &, const char * const filename,
+                     const bool mapFile);
+void LoadInput(AvidaOrganismTable &, InputFile &, const bool isDetail,
+               ThreadPool &) throw(pair<int,int>);
+const double InputSize(InputFile &);
+const bool DecompressionFailed(InputFile &historicIn, InputFile &detailIn);
+void CloseInput(InputFile &);
+void ReadAppended(const char * const filename, size_t &offset,
+                  string &text) throw(int);
+void PrepareTree(Tree &, OutputStream &);
+void PrintTreeInformation(const Tree &, OutputStream &);
+const int ReplicateSeed(const int seed, const unsigned int replicate);
+const char *MethodName(const int method);
+void RunSample(const SubtreeSampler &, Tree &sample,
+               const unsigned int replicate,
+               const int seed,
+               const unsigned int leavesToSample,
+               const double timeCutoff,
+               const vector<SampleMetric> &,
+               const bool generateReport,
+               const bool generateNewick,
+               const char * const newickFilenameBase,
+               const char * const outFilename,
+               SampleOutput &);
+void RunSamples(const Tree &, ThreadPool &,
+                const int seed,
+                unsigned int samples,
+                unsigned int leavesToSample,
+                const double timeCutoff,
+                const vector<SampleMetric> &,
+                const bool generateReport,
+                const bool generateNewick,
+                const char * const newickFilenameBase,
+                const char * const outFilename);
 
 /*** Global Variables *******************************************************/
 // Used to control whether console output is displayed.
@@ -77,6 +203,8 @@ RandomNumberGenerator rng;
 void Run(const char * const historicFilename,
          const char * const detailFilename,
          const bool verboseOn,
+         const bool useMappedFiles,
+         const bool useCache,
          const bool outputToFile,
          const bool generateReport,
          const bool generateNewick,
@@ -85,20 +213,76 @@ void Run(const char * const historicFilename,
          const bool calcBalance,
          unsigned int samples,
          unsigned int leavesToSample,
-         unsigned int timeCutoff)
+         unsigned int timeCutoff,
+         unsigned int threads,
+         const int seed,
+         const int bornCutoff,
+         const int followSeconds,
+         const unsigned int refreshes)
 {
   // Setup output
   output.SetShowState(verboseOn);
 
-  // Load organisms
-  vector<iOrganism*> organisms;
-  try { LoadOrganisms(organisms, historicFilename, detailFilename); }
-  catch(int) { return; }
+  // Threads used for loading and for the sample replicates
+  ThreadPool pool(threads);
+
+  // Load organisms.  The trees only use the fields every organism has, so
+  //   none of the other Avida columns are converted or kept.  A negative
+  //   bornCutoff loads every organism.
+  AvidaOrganismTable organisms;
+  organisms.SelectColumns(AvidaOrganismTable::NoColumns);
+  if(bornCutoff >= 0)
+  {
+    organisms.SetRowFilter([bornCutoff](const AvidaOrganism &o) -> const bool
+    {
+      return o.GetUpdateBorn() <= bornCutoff;
+    });
+  }
+
+  // Work out the tree's shape while the organisms are being loaded.
+  TreeBuilder builder;
+  organisms.SetTreeBuilder(&builder);
+
+  // Following the historic file needs every organism, not the prepared
+  //   tree a cache holds, and where the historic file was read up to.
+  const bool following = followSeconds >= 0 && historicFilename != 0;
+  size_t historicLoaded = 0;
+
+  // A prepared tree cached by an earlier run on the same files replaces
+  //   loading and preparing the tree.  It is kept next to the detail file.
+  vector<const char*> inputFilenames;
+  inputFilenames.push_back(historicFilename);
+  inputFilenames.push_back(detailFilename);
+  const string cacheFilename = (detailFilename != 0)
+    ? string(detailFilename) + ".tree" : string();
+  bool fromCache = false;
+  if(useCache && !following && historicFilename != 0 && detailFilename != 0)
+  {
+    output << "Checking for cached tree     ... ";
+    try
+    {
+      fromCache = LoadTreeCache(organisms, cacheFilename.c_str(),
+                                inputFilenames, bornCutoff);
+    }
+    catch(int) { fromCache = false; }
+    output << ((fromCache) ? "found." : "none.") << endl << endl;
+  }
+
+  if(!fromCache)
+  {
+    try
+    {
+      LoadOrganisms(organisms, historicFilename, detailFilename,
+                    useMappedFiles, pool,
+                    (following) ? &historicLoaded : 0);
+    }
+    catch(int) { return; }
+  }
 
   // Create and process the full tree
   Tree *fullTree = 0;
   output << "Creating full tree-" << endl;
-  try { fullTree = new Tree(organisms); }
+  try { fullTree = new Tree(organisms, builder); }
   catch(int x)
   {
     output << "Failed to create tree - " << x << endl;
@@ -106,8 +290,36 @@ void Run(const char * const historicFilename,
     return;
   }
 
-  try { PrepareTree(*fullTree); }
-  catch(int) { Cleanup(&fullTree, organisms); return; }
+  // Only following the historic file needs the builder after this.
+  if(!following)
+  {
+    organisms.SetTreeBuilder(0);
+    builder.Clear();
+  }
+
+  if(fromCache)
+  {
+    try { PrintTreeInformation(*fullTree, output); }
+    catch(int) { Cleanup(&fullTree, organisms); return; }
+  }
+  else
+  {
+    try { PrepareTree(*fullTree, output); }
+    catch(int) { Cleanup(&fullTree, organisms); return; }
+
+    if(useCache)
+    {
+      // Not being able to save the cache only costs later runs time.
+      output << "Saving tree cache            ... ";
+      try
+      {
+        SaveTreeCache(*fullTree, cacheFilename.c_str(), inputFilenames,
+                      bornCutoff);
+        output << "Complete." << endl << endl;
+      }
+      catch(int) { output << "Failed." << endl << endl; }
+    }
+  }
 
   // Create Newick Output
   if(generateNewick == true)
@@ -179,14 +391,27 @@ void Run(const char * const historicFilename,
     }
   }
 
+  // The metrics all read one flattened copy of the full tree.
+  FlatTree *flatTree = 0;
+  if(calcGamma || calcNCStem || calcBalance)
+  {
+    try { flatTree = new FlatTree(*fullTree); }
+    catch(int)
+    {
+      output << "Failed to flatten the full tree." << endl;
+      Cleanup(&fullTree, organisms);
+      return;
+    }
+  }
+
   // Calculate gamma for the full tree
   double gammaValue = 0;
   if(calcGamma)
   {
     output << "Calculate gamma for the full tree-" << endl;
-    gammaValue = CalculateGamma(*fullTree,
+    gammaValue = CalculateGamma(*flatTree,
                                 (outputToFile) ? detailFilename : 0,
-                                 static_cast<double>(timeCutoff));
+                                 static_cast<double>(timeCutoff), output);
     if(generateReport == true)
     {
       gammaReportFileTxt << "1 0        " << gammaValue << endl;
@@ -199,9 +424,9 @@ void Run(const char * const historicFilename,
   if(calcNCStem)
   {
     output << "Calculate noncumulative stemminess for the full tree-" << endl;
-    ncstemValue = CalculateNCStem(*fullTree,
+    ncstemValue = CalculateNCStem(*flatTree,
                                   (outputToFile) ? detailFilename : 0,
-                                  static_cast<double>(timeCutoff));
+                                  static_cast<double>(timeCutoff), output);
     if(generateReport == true)
     {
       ncstemReportFileTxt << "1 0        " << ncstemValue << endl;
@@ -214,46 +439,56 @@ void Run(const char * const historicFilename,
   if(calcBalance)
   {
     output << "Calculate balance for the full tree-" << endl;
-    balanceValue = CalculateBalance(*fullTree,
+    balanceValue = CalculateBalance(*flatTree,
                                     generateReport,
                                     balanceReportFileTxt, balanceReportFileCsv,
-                                    balanceListFileTxt, balanceListFileCsv);
+                                    balanceListFileTxt, balanceListFileCsv,
+                                    output);
   }
 
-  // Calculate samples
+  if(flatTree != 0) { delete flatTree; }
+  flatTree = 0;
+
+  // Calculate samples.  Every replicate's generator is seeded from this
+  //   seed, so a run can be repeated by giving it the seed it reports.
+  //   Without one the seed comes from the clock, and may be 0.
   if(samples != 0 && leavesToSample != 0)
   {
-    try
-    {
-      if(calcGamma)
-        RunSamples(*fullTree, samples, leavesToSample, gammaValue,
-                   static_cast<double>(timeCutoff),
-                   1, // method == 1 == gamma
-                   generateReport, generateNewick,
-                   gammaReportFileTxt, gammaReportFileCsv,
-                   gammaReportFileTxt, gammaReportFileCsv,
-                   detailFilename,
-                   (outputToFile) ? detailFilename : 0);
+    const int sampleSeed = (seed >= 0) ? seed : rng.GetSeed();
+    output << "Sample seed = " << sampleSeed << endl << endl;
 
-      if(calcNCStem)
-        RunSamples(*fullTree, samples, leavesToSample, ncstemValue,
-                   static_cast<double>(timeCutoff),
-                   2, // method == 2 == NCStem
-                   generateReport, generateNewick,
-                   ncstemReportFileTxt, ncstemReportFileCsv,
-                   ncstemReportFileTxt, ncstemReportFileCsv,
-                   detailFilename,
-                   (outputToFile) ? detailFilename : 0);
+    // Every enabled metric is computed on each sample, so each sample is
+    //   only made once and the metrics all see the same samples.
+    vector<SampleMetric> metrics;
+    if(calcGamma)
+    {
+      SampleMetric m = {1, gammaValue,
+                        &gammaReportFileTxt, &gammaReportFileCsv,
+                        &gammaReportFileTxt, &gammaReportFileCsv};
+      metrics.push_back(m);
+    }
+    if(calcNCStem)
+    {
+      SampleMetric m = {2, ncstemValue,
+                        &ncstemReportFileTxt, &ncstemReportFileCsv,
+                        &ncstemReportFileTxt, &ncstemReportFileCsv};
+      metrics.push_back(m);
+    }
+    if(calcBalance)
+    {
+      SampleMetric m = {3, balanceValue,
+                        &balanceReportFileTxt, &balanceReportFileCsv,
+                        &balanceListFileTxt, &balanceListFileCsv};
+      metrics.push_back(m);
+    }
 
-      if(calcBalance)
-        RunSamples(*fullTree, samples, leavesToSample, balanceValue,
-                   static_cast<double>(timeCutoff),
-                   3, // method == 3 == Balance
-                   generateReport, generateNewick,
-                   balanceReportFileTxt, balanceReportFileCsv,
-                   balanceListFileTxt, balanceListFileCsv,
-                   detailFilename,
-                   (outputToFile) ? detailFilename : 0);
+    try
+    {
+      RunSamples(*fullTree, pool, sampleSeed, samples, leavesToSample,
+                 static_cast<double>(timeCutoff), metrics,
+                 generateReport, generateNewick,
+                 detailFilename,
+                 (outputToFile) ? detailFilename : 0);
     }
     catch(...)
     {
@@ -271,6 +506,7 @@ void Run(const char * const historicFilename,
         balanceListFileCsv.close();
       }
       Cleanup(&fullTree, organisms);
+      return;
     }
   }
 
@@ -287,6 +523,31 @@ void Run(const char * const historicFilename,
     balanceListFileCsv.close();
   }
 
+  if(following)
+  {
+    // The prepared tree has lost nodes that appended records may descend
+    //   from, so follow with a tree of every organism instead.
+    delete fullTree;
+    fullTree = 0;
+
+    Tree *growingTree = 0;
+    try { growingTree = new Tree(organisms, builder); }
+    catch(int x)
+    {
+      output << "Failed to create tree - " << x << endl;
+      Cleanup(0, organisms);
+      return;
+    }
+
+    Follow(organisms, builder, *growingTree, historicFilename, detailFilename,
+           historicLoaded, static_cast<unsigned int>(followSeconds),
+           refreshes, generateReport, calcGamma, calcNCStem, calcBalance,
+           static_cast<double>(timeCutoff));
+
+    delete growingTree;
+    organisms.SetTreeBuilder(0);
+  }
+
   // Clean up data
   Cleanup(&fullTree, organisms);
 
@@ -294,9 +555,10 @@ void Run(const char * const historicFilename,
 }
 
 /*** Global Function Definitions ********************************************/
-const double CalculateGamma(const Tree &tree,
+const double CalculateGamma(const FlatTree &tree,
                             const char * const detailFilename,
-                            const double timeCutoff)
+                            const double timeCutoff,
+                            OutputStream &output)
 {
   // Calculate gamma for the given tree
   const double value = ComputeGamma(tree,
@@ -310,9 +572,10 @@ const double CalculateGamma(const Tree &tree,
   return value;
 }
 
-const double CalculateNCStem(const Tree &tree,
+const double CalculateNCStem(const FlatTree &tree,
                              const char * const detailFilename,
-                             const double timeCutoff)
+                             const double timeCutoff,
+                             OutputStream &output)
 {
   // Calculate noncumulative stemminess for the given tree
   const double value = NoncumulativeStem(tree,
@@ -326,10 +589,11 @@ const double CalculateNCStem(const Tree &tree,
   return value;
 }
 
-const double CalculateBalance(const Tree &tree,
+const double CalculateBalance(const FlatTree &tree,
                               const bool generateReport,
                               ostream &reportTxt, ostream &reportCsv,
-                              ostream &listTxt, ostream &listCsv)
+                              ostream &listTxt, ostream &listCsv,
+                              OutputStream &output)
 {
   try
   {
@@ -350,25 +614,70 @@ const double CalculateBalance(const Tree &tree,
   return 0.0;
 }
 
-void Cleanup(Tree **fullTree, vector<iOrganism*> &organisms)
+const unsigned int AddFollowed(OrganismTable &organisms,
+                               const TreeBuilder &builder,
+                               const OrganismTable &appended,
+                               PendingOrganisms &pending,
+                               unsigned int &pendingCount)
 {
-  // Clean up tree
+  // Organisms are added so that every parent comes before its children,
+  //   which lets the tree be extended one node at a time.  Records whose
+  //   parent has not been seen wait in pending until it is.
+  const unsigned int before = organisms.Size();
+  vector<PendingOrganism> ready;
+  for(unsigned int r = 0; r < appended.Size(); ++r)
+  {
+    PendingOrganism o = {appended.GetId(r), appended.GetParentId(r),
+                         appended.GetBirthTime(r), appended.GetIsAlive(r)};
+
+    // An organism already loaded, e.g. alive in the detail file, has died.
+    const int slot = builder.FindSlot(o.id);
+    if(slot >= 0)
+    {
+      const unsigned int row = static_cast<unsigned int>(slot);
+      organisms.SetIsAlive(row, organisms.GetIsAlive(row) && o.isAlive);
+      continue;
+    }
+
+    // A new root can never be joined to the tree, so it waits forever.
+    if(builder.FindSlot(o.parentId) < 0)
+    {
+      pending[o.parentId].push_back(o);
+      ++pendingCount;
+      continue;
+    }
+
+    ready.push_back(o);
+    while(!ready.empty())
+    {
+      o = ready.back();
+      ready.pop_back();
+      organisms.Append(o.id, o.parentId, o.birthTime, o.isAlive);
+
+      PendingOrganisms::iterator w = pending.find(o.id);
+      if(w != pending.end())
+      {
+        ready.insert(ready.end(), w->second.rbegin(), w->second.rend());
+        pendingCount -= static_cast<unsigned int>(w->second.size());
+        pending.erase(w);
+      }
+    }
+  }
+
+  return organisms.Size() - before;
+}
+
+void Cleanup(Tree **fullTree, AvidaOrganismTable &organisms)
+{
+  // Clean up tree, which refers to the organisms so must go first
   if(fullTree != 0 && *fullTree != 0)
   {
     delete *fullTree;
     *fullTree = 0;
   }
 
-  // Clean up and delete organisms
-  vector<iOrganism*>::iterator oi = organisms.begin();
-  for(; oi != organisms.end(); ++oi)
-  {
-    if(*oi != 0)
-    {
-      delete *oi;
-      *oi = 0;
-    }
-  }
+  // Release the organisms
+  organisms.Clear();
 
   return;
 }
@@ -413,65 +722,121 @@ void CreateOutput(const char * const detailFilename, const char *const extension
   return;
 }
 
-void LoadOrganisms(vector<iOrganism*> &organisms,
+void LoadOrganisms(AvidaOrganismTable &organisms,
                    const char * const historicFilename,
-                   const char * const detailFilename)
+                   const char * const detailFilename,
+                   const bool mapFiles,
+                   ThreadPool &pool,
+                   size_t *historicLoaded)
 {
-  // open input files
-  ifstream detailIn(detailFilename);
-  ifstream historicIn(historicFilename);
-  if(!detailIn || !historicIn)
+  // Parsing on several threads needs the whole file in memory.
+  const bool useMappedFiles = mapFiles || pool.Size() > 1;
+
+  // open input files, either as streams or mapped into memory.  A followed
+  //   historic file is mapped so exactly what was loaded is known.
+  InputFile historicIn;
+  InputFile detailIn;
+  const bool historicOpened = OpenInput(historicIn, historicFilename,
+                                        useMappedFiles ||
+                                        historicLoaded != 0);
+  const bool detailOpened   = OpenInput(detailIn, detailFilename,
+                                        useMappedFiles);
+  if(!detailOpened || !historicOpened)
   {
-    if(!historicIn)   { output << "Could not open historic file." << endl; }
-    else              { historicIn.close(); }
-
-    if(!detailIn) { output << "Could not open detail file."   << endl; }
-    else          { detailIn.close(); }
+    if(!historicOpened) { output << "Could not open historic file." << endl; }
+    if(!detailOpened)   { output << "Could not open detail file."   << endl; }
 
+    // Any file that was opened is closed when it goes out of scope.
     throw 1;
   }
   output << "Historic and detail files opened." << endl << endl;
 
+  if(historicLoaded != 0)
+  {
+    if(historicIn.isCompressed)
+    {
+      output << "A compressed historic file can not be followed." << endl;
+      throw 1;
+    }
+
+    // Leave a partly written last line to be read when following.
+    const char * const begin = historicIn.map.Begin();
+    while(historicIn.length > 0 && begin[historicIn.length - 1] != '\n')
+    {
+      --historicIn.length;
+    }
+    *historicLoaded = historicIn.length;
+  }
+
   // Load in organisms from file.
   output << "Loading input files- " << endl;
 
+  const chrono::steady_clock::time_point loadStart =
+    chrono::steady_clock::now();
   try
   {
     // load files
     output << "Loading historic file        ... ";
-    LoadAvidaOrganisms(organisms, historicIn, false);
+    LoadInput(organisms, historicIn, false, pool);
     output << "Loaded." << endl;
 
     output << "Loading detail file          ... ";
-    LoadAvidaOrganisms(organisms, detailIn, true);
+    LoadInput(organisms, detailIn, true, pool);
     output << "Loaded." << endl;
   }
   catch(pair<int,int> errorData)
   {
-    // output the error that occurred while processing a line
+    // output the error that occurred while processing a line.  A damaged
+    //   compressed file ends in a partial line, so report the damage instead.
     output << "Failed." << endl;
-    output << errorData.first << "\t error - " << errorData.second;
-    output << endl;
+    if(!DecompressionFailed(historicIn, detailIn))
+    {
+      output << errorData.first << "\t error - " << errorData.second;
+      output << endl;
+    }
     output << "Abandoning build." << endl;
     Cleanup(0, organisms);
 
-    // Close input files
-    historicIn.close();
-    detailIn.close();
+    // Input files are closed when they go out of scope.
+    throw 2;
+  }
+  const double loadSeconds = chrono::duration<double>(
+    chrono::steady_clock::now() - loadStart).count();
 
+  // A damaged compressed file may also end on a whole line.
+  if(DecompressionFailed(historicIn, detailIn))
+  {
+    output << "Abandoning build." << endl;
+    Cleanup(0, organisms);
     throw 2;
   }
 
+  // Total (decompressed) input size, used to report the load rate.
+  const double bytes = InputSize(historicIn) + InputSize(detailIn);
+
+  output << "Loaded " << bytes / 1048576.0 << " MB in " << loadSeconds;
+  output << " seconds";
+  if(loadSeconds > 0)
+  {
+    output << " (" << bytes / 1048576.0 / loadSeconds << " MB/s)";
+  }
+  output << "." << endl;
+
   // Close input files
-  historicIn.close();
-  detailIn.close();
+  CloseInput(historicIn);
+  CloseInput(detailIn);
 
   // Check for duplicate organism ids
   output << "Checking for duplicate ids   ... ";
   try
   {
-    set<int> duplicateIds = CheckForDuplicateIds(organisms);
-    if(!duplicateIds.empty()) { throw 0; }
+    // An attached builder has already checked every id as it was loaded.
+    const TreeBuilder *builder = organisms.GetTreeBuilder();
+    if(builder != 0)
+    {
+      if(!builder->GetDuplicateIds().empty()) { throw 0; }
+    }
+    else if(!CheckForDuplicateIds(organisms).empty()) { throw 0; }
   }
   catch(int)
   {
@@ -484,7 +849,266 @@ void LoadOrganisms(vector<iOrganism*> &organisms,
   return;
 }
 
-void PrepareTree(Tree &fullTree)
+const double StreamSize(istream &in)
+{
+  // Measure the stream by seeking to its end, then return to the beginning.
+  in.seekg(0, ios::end);
+  const double size = static_cast<double>(in.tellg());
+  in.seekg(0, ios::beg);
+
+  return (size > 0) ? size : 0;
+}
+
+const bool OpenInput(InputFile &in, const char * const filename,
+                     const bool mapFile)
+{
+  if(filename == 0) { return false; }
+
+  const CompressedFile::Format format = CompressedFile::DetectFormat(filename);
+  if(format != CompressedFile::Plain)
+  {
+    in.isCompressed = true;
+    try { in.compressed.Open(filename); }
+    catch(int x)
+    {
+      if(x == 2) { output << "Unsupported compression: " << filename << endl; }
+      return false;
+    }
+  }
+  else if(mapFile)
+  {
+    in.isMapped = true;
+    try { in.map.Open(filename); }
+    catch(int) { return false; }
+    in.length = in.map.Size();
+  }
+  else
+  {
+    in.stream.open(filename);
+    if(!in.stream.is_open()) { return false; }
+  }
+
+  return true;
+}
+
+void LoadInput(AvidaOrganismTable &organisms, InputFile &in,
+               const bool isDetail, ThreadPool &pool) throw(pair<int,int>)
+{
+  // Compressed files are parsed as they are decompressed, so on the calling
+  //   thread only.
+  if(in.isCompressed)
+  {
+    LoadAvidaOrganisms(organisms, in.decompressed, isDetail);
+  }
+  else if(in.isMapped)
+  {
+    LoadAvidaOrganisms(organisms, in.map.Begin(), in.map.Begin() + in.length,
+                       isDetail, pool);
+  }
+  else
+  {
+    LoadAvidaOrganisms(organisms, in.stream, isDetail);
+  }
+
+  return;
+}
+
+const double InputSize(InputFile &in)
+{
+  if(in.isCompressed)
+  {
+    return static_cast<double>(in.compressed.DecompressedSize());
+  }
+  if(in.isMapped) { return static_cast<double>(in.length); }
+
+  // The stream has been read to its end, which leaves it failed.
+  in.stream.clear();
+  return StreamSize(in.stream);
+}
+
+const bool DecompressionFailed(InputFile &historicIn, InputFile &detailIn)
+{
+  const bool historicFailed = historicIn.compressed.Failed();
+  const bool detailFailed = detailIn.compressed.Failed();
+  if(historicFailed) { output << "Could not decompress historic file." << endl; }
+  if(detailFailed)   { output << "Could not decompress detail file."   << endl; }
+
+  return historicFailed || detailFailed;
+}
+
+void CloseInput(InputFile &in)
+{
+  in.stream.close();
+  in.map.Close();
+  in.compressed.Close();
+
+  return;
+}
+
+void ReadAppended(const char * const filename, size_t &offset,
+                  string &text) throw(int)
+{
+  text.clear();
+
+  ifstream in(filename, ios::in | ios::binary);
+  if(!in) { throw 1; }
+
+  in.seekg(0, ios::end);
+  const streamoff size = in.tellg();
+  if(size < 0 || static_cast<size_t>(size) < offset) { throw 1; }
+  if(static_cast<size_t>(size) == offset) { return; }
+
+  text.resize(static_cast<size_t>(size) - offset);
+  in.seekg(static_cast<streamoff>(offset), ios::beg);
+  in.read(&text[0], static_cast<streamsize>(text.size()));
+  if(static_cast<size_t>(in.gcount()) != text.size()) { throw 1; }
+
+  // Only whole lines are taken; the rest is read again next time.
+  const size_t lastNewline = text.rfind('\n');
+  if(lastNewline == string::npos)
+  {
+    text.clear();
+    return;
+  }
+  text.resize(lastNewline + 1);
+  offset += text.size();
+
+  return;
+}
+
+void Follow(AvidaOrganismTable &organisms, TreeBuilder &builder,
+            Tree &growingTree,
+            const char * const historicFilename,
+            const char * const detailFilename,
+            size_t offset,
+            const unsigned int seconds,
+            const unsigned int refreshes,
+            const bool generateReport,
+            const bool calcGamma,
+            const bool calcNCStem,
+            const bool calcBalance,
+            const double timeCutoff)
+{
+  // One line per refresh with the full tree metrics.
+  ofstream txt;
+  ofstream csv;
+  if(generateReport)
+  {
+    try { CreateOutput(detailFilename, "follow", txt, csv); }
+    catch(int) { return; }
+
+    txt << "#Refresh  Organisms  Nodes";
+    csv << "Refresh, Organisms, Nodes";
+    if(calcGamma)   { txt << "  Gamma";   csv << ", Gamma";   }
+    if(calcNCStem)  { txt << "  NCStem";  csv << ", NCStem";  }
+    if(calcBalance) { txt << "  Balance"; csv << ", Balance"; }
+    txt << endl;
+    csv << endl;
+  }
+
+  // Appended records are filtered the same way as the organisms were, but
+  //   only the fields every organism has are added, as Run loads no others.
+  AvidaOrganismTable appended;
+  appended.SelectColumns(AvidaOrganismTable::NoColumns);
+  appended.SetRowFilter(organisms.GetRowFilter());
+
+  PendingOrganisms pending;
+  unsigned int pendingCount = 0;
+  string text;
+  for(unsigned int refresh = 1; refreshes == 0 || refresh <= refreshes;
+      ++refresh)
+  {
+    this_thread::sleep_for(chrono::seconds(seconds));
+
+    try { ReadAppended(historicFilename, offset, text); }
+    catch(int)
+    {
+      output << "Could not read the historic file, stopped following it.";
+      output << endl;
+      break;
+    }
+    if(text.empty()) { continue; }
+
+    output << "Refresh " << refresh << "-" << endl;
+    try
+    {
+      LoadAvidaOrganisms(appended, text.data(), text.data() + text.size(),
+                         false);
+    }
+    catch(pair<int,int> errorData)
+    {
+      // Line numbers count from the first appended line.
+      output << "Failed to load appended records." << endl;
+      output << errorData.first << "\t error - " << errorData.second;
+      output << endl;
+      break;
+    }
+
+    const unsigned int added = AddFollowed(organisms, builder, appended,
+                                           pending, pendingCount);
+    appended.Clear();
+    output << "Added " << added << " organisms, " << pendingCount;
+    output << " waiting for their parents." << endl;
+    if(added == 0) { continue; }
+
+    try { growingTree.Extend(organisms, builder); }
+    catch(int x)
+    {
+      output << "Failed to extend tree - " << x << endl;
+      break;
+    }
+
+    // The metrics need the prepared tree, which is made from a copy so
+    //   later records can still be added to the growing one.
+    Tree fullTree(growingTree);
+    RemoveNonfurcatingNodes(fullTree);
+
+    FlatTree *flatTree = 0;
+    try { flatTree = new FlatTree(fullTree); }
+    catch(int)
+    {
+      output << "Failed to flatten tree." << endl;
+      break;
+    }
+
+    double gammaValue = 0;
+    double ncstemValue = 0;
+    double balanceValue = 0;
+    if(calcGamma)
+    {
+      gammaValue = CalculateGamma(*flatTree, 0, timeCutoff, output);
+    }
+    if(calcNCStem)
+    {
+      ncstemValue = CalculateNCStem(*flatTree, 0, timeCutoff, output);
+    }
+    if(calcBalance)
+    {
+      ostream none(0);
+      balanceValue = CalculateBalance(*flatTree, false,
+                                      none, none, none, none, output);
+    }
+    delete flatTree;
+
+    if(generateReport)
+    {
+      txt << refresh << "  " << organisms.Size() << "  " << fullTree.Size();
+      csv << refresh << ", " << organisms.Size() << ", " << fullTree.Size();
+      if(calcGamma)   { txt << "  " << gammaValue;   csv << ", " << gammaValue; }
+      if(calcNCStem)  { txt << "  " << ncstemValue;  csv << ", " << ncstemValue; }
+      if(calcBalance) { txt << "  " << balanceValue; csv << ", " << balanceValue; }
+      txt << endl;
+      csv << endl;
+    }
+  }
+
+  txt.close();
+  csv.close();
+
+  return;
+}
+
+void PrepareTree(Tree &fullTree, OutputStream &output)
 {
   // Validate all nodes, no missing nodes in the list and valid ids/parentId
   //output << "Validating tree              ... ";
@@ -518,6 +1142,13 @@ void PrepareTree(Tree &fullTree)
   RemoveNonfurcatingNodes(fullTree);
   output << "Complete." << endl;
 
+  PrintTreeInformation(fullTree, output);
+
+  return;
+}
+
+void PrintTreeInformation(const Tree &fullTree, OutputStream &output)
+{
   // Output tree information
   output << endl;
   if(output.GetShowState() == true && output.GetStream() != 0 &&
@@ -530,47 +1161,99 @@ void PrepareTree(Tree &fullTree)
   return;
 }
 
-const double RunSamples(const Tree &fullTree,
-                        unsigned int inputSamples,
-                        unsigned int inputLeavesToSample,
-                        const double trueValue,
-                        const double timeCutoff,
-                        const int method,
-                        const bool generateReport,
-                        const bool generateNewick,
-                        ostream &reportTxt,
-                        ostream &reportCsv,
-                        ostream &listTxt,
-                        ostream &listCsv,
-                        const char * const newickFilenameBase,
-                        const char * const outFilename)
+const int ReplicateSeed(const int seed, const unsigned int replicate)
 {
-  if(inputSamples == 0 || inputLeavesToSample == 0) { return 0; }
+  // Mix the seed and the index (splitmix64) so that neighbouring replicates
+  //   do not get neighbouring seeds.
+  uint64_t z = (static_cast<uint64_t>(static_cast<uint32_t>(seed)) << 32) +
+               replicate + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z = z ^ (z >> 31);
+
+  // RandomNumberGenerator keeps seeds below 161803398, and one of zero or
+  //   less would seed it from the clock.
+  return static_cast<int>(z % 161803397) + 1;
+}
 
-  double total = 0;
-  unsigned int samples = inputSamples;
-  unsigned int sampleSize = inputLeavesToSample;
-  for(unsigned int i = 0; i < samples; ++i)
+const char *MethodName(const int method)
+{
+  if(method == 1)      return "Gamma";
+  else if(method == 2) return "NCStem";
+  else if(method == 3) return "Balance";
+
+  return "";
+}
+
+void RunSample(const SubtreeSampler &sampler, Tree &sample,
+               const unsigned int i,
+               const int seed,
+               const unsigned int sampleSize,
+               const double timeCutoff,
+               const vector<SampleMetric> &metrics,
+               const bool generateReport,
+               const bool generateNewick,
+               const char * const newickFilenameBase,
+               const char * const outFilename,
+               SampleOutput &result)
+{
+  OutputStream output(&result.console, ::output.GetShowState());
+
+  try
   {
-    Tree *sampleTree = 0;
-    try
+    output << "Working on sample " << i+1 << endl;
+
+    RandomNumberGenerator replicateRng(ReplicateSeed(seed, i));
+    sampler.Sample(sampleSize, replicateRng, sample);
+
+    try { PrepareTree(sample, output); }
+    catch(int)
     {
-      output << "Working on sample " << i+1 << endl;
+      output << "Failed to prepare sample tree." << endl;
+      throw 2;
+    }
 
-      sampleTree = Sample(fullTree, sampleSize, rng);
-      if(sampleTree == 0)
-      {
-        output << "Failed to create a sample from the full tree." << endl;
-        throw 1;
-      }
+    // The sample is written once however many metrics use it.  A lone
+    //   metric keeps its name in the file name, as before.
+    if(generateNewick)
+    {
+      char newickFilename[256];
+      stringstream ssOutFilename;
+      ssOutFilename << newickFilenameBase;
+      const int method = (metrics.size() == 1) ? metrics.front().method : 0;
+      if(method == 1)      ssOutFilename << ".gamma";
+      else if(method == 2) ssOutFilename << ".ncstem";
+      else if(method == 3) ssOutFilename << ".balance";
+      ssOutFilename << ".sample" << i+1 << '\0';
+      strcpy(newickFilename, ssOutFilename.str().c_str());
+
+      NewickOutput(sample, timeCutoff, newickFilename, output);
+    }
+  }
+  catch(int)
+  {
+    output << "Failed to sample the full tree." << endl;
+    for(size_t m = 0; m < metrics.size(); ++m)
+    {
+      result.metrics[m].failed = true;
+    }
+    return;
+  }
 
-      try { PrepareTree(*sampleTree); }
-      catch(int)
-      {
-        output << "Failed to prepare sample tree." << endl;
-        throw 2;
-      }
+  const FlatTree flatSample(sample);
+  for(size_t m = 0; m < metrics.size(); ++m)
+  {
+    const int method = metrics[m].method;
+    MetricOutput &metric = result.metrics[m];
+    ostream &reportTxt = metric.reportTxt;
+    ostream &reportCsv = metric.reportCsv;
+    // Gamma and NCStem list into their reports.
+    const bool listIsReport = (metrics[m].listTxt == metrics[m].reportTxt);
+    ostream &listTxt = (listIsReport) ? reportTxt : metric.listTxt;
+    ostream &listCsv = (listIsReport) ? reportCsv : metric.listCsv;
 
+    try
+    {
       char *name = 0;
       char filename[256];
       if(outFilename)
@@ -586,29 +1269,15 @@ const double RunSamples(const Tree &fullTree,
         name = filename;
       }
 
-      if(generateNewick)
-      {
-        char newickFilename[256];
-        stringstream ssOutFilename2;
-        ssOutFilename2 << newickFilenameBase;
-        if(method == 1)      ssOutFilename2 << ".gamma";
-        else if(method == 2) ssOutFilename2 << ".ncstem";
-        else if(method == 3) ssOutFilename2 << ".balance";
-        ssOutFilename2 << ".sample" << i+1 << '\0';
-        strcpy(newickFilename, ssOutFilename2.str().c_str());
-
-        NewickOutput(*sampleTree, timeCutoff, newickFilename, output);
-      }
-
       double value = 0;
       if(method == 1)
-        value = CalculateGamma(*sampleTree, name, timeCutoff);
+        value = CalculateGamma(flatSample, name, timeCutoff, output);
       else if(method == 2)
-        value = CalculateNCStem(*sampleTree, name, timeCutoff);
+        value = CalculateNCStem(flatSample, name, timeCutoff, output);
       else if(method == 3)
-        value = CalculateBalance(*sampleTree, generateReport,
+        value = CalculateBalance(flatSample, generateReport,
                                  reportTxt, reportCsv,
-                                 listTxt, listCsv);
+                                 listTxt, listCsv, output);
       else throw 3;
 
       if(generateReport && (method == 1 || method == 2))
@@ -620,33 +1289,108 @@ const double RunSamples(const Tree &fullTree,
         reportTxt << endl;
         reportCsv << "Sample," << i+1 << "," << value << endl;
       }
-      total += value;
+      metric.value = value;
     }
     catch(int)
     {
       output << "Failed to sample the full tree." << endl;
+      metric.failed = true;
     }
-    if(sampleTree != 0) { delete sampleTree; }
   }
 
-  output << "True ";
+  return;
+}
 
-  if(method == 1) output << "Gamma";
-  else if(method == 2) output << "NCStem";
-  else if(method == 3) output << "Balance";
+void RunSamples(const Tree &fullTree,
+                ThreadPool &pool,
+                const int seed,
+                unsigned int inputSamples,
+                unsigned int inputLeavesToSample,
+                const double timeCutoff,
+                const vector<SampleMetric> &metrics,
+                const bool generateReport,
+                const bool generateNewick,
+                const char * const newickFilenameBase,
+                const char * const outFilename)
+{
+  if(inputSamples == 0 || inputLeavesToSample == 0) { return; }
+  if(metrics.empty()) { return; }
 
-  output << " = " << trueValue << endl;
-  output << "Average ";
+  vector<double> totals(metrics.size(), 0);
+  unsigned int samples = inputSamples;
+  unsigned int sampleSize = inputLeavesToSample;
+  // Every sample is built from its leaves rather than from a copy of the
+  //   full tree.  The sampler only reads the full tree, so every thread
+  //   shares it.
+  SubtreeSampler *sampler = 0;
+  try { sampler = new SubtreeSampler(fullTree); }
+  catch(int)
+  {
+    output << "Failed to prepare the full tree for sampling." << endl;
+    return;
+  }
 
-  if(method == 1) output << "Gamma";
-  else if(method == 2) output << "NCStem";
-  else if(method == 3) output << "Balance";
+  // Each replicate draws from its own generator, seeded from seed and its
+  //   index, so the samples do not depend on how many threads run them.
+  //   Finished replicates wait in finished until those before them are
+  //   written, and the totals are summed in that order too.
+  vector<SampleOutput*> finished(samples, static_cast<SampleOutput*>(0));
+  unsigned int written = 0;
+  atomic<unsigned int> next(0);
+  mutex writing;
+  const unsigned int tasks = (pool.Size() < samples) ? pool.Size() : samples;
+  try
+  {
+    pool.Run(tasks, [&](unsigned int)
+    {
+      // A thread builds all of its samples into one tree to reuse its memory.
+      Tree sample;
+      for(unsigned int i = next++; i < samples; i = next++)
+      {
+        SampleOutput *result = new SampleOutput(metrics.size());
+        RunSample(*sampler, sample, i, seed, sampleSize, timeCutoff, metrics,
+                  generateReport, generateNewick,
+                  newickFilenameBase, outFilename, *result);
+
+        lock_guard<mutex> guard(writing);
+        finished[i] = result;
+        for(; written < samples && finished[written] != 0; ++written)
+        {
+          SampleOutput *done = finished[written];
+          output << done->console.str();
+          for(size_t m = 0; m < metrics.size(); ++m)
+          {
+            const MetricOutput &metric = done->metrics[m];
+            *metrics[m].reportTxt << metric.reportTxt.str();
+            *metrics[m].reportCsv << metric.reportCsv.str();
+            *metrics[m].listTxt << metric.listTxt.str();
+            *metrics[m].listCsv << metric.listCsv.str();
+            if(!metric.failed) { totals[m] += metric.value; }
+          }
+
+          delete done;
+          finished[written] = 0;
+        }
+      }
+    });
+  }
+  catch(...)
+  {
+    for(unsigned int i = 0; i < samples; ++i) { delete finished[i]; }
+    delete sampler;
+    throw;
+  }
+  delete sampler;
 
-  output << " = " << total;
-  output << " / " << samples << " = ";
-  double average = total / samples;
-  output << average << endl;
+  for(size_t m = 0; m < metrics.size(); ++m)
+  {
+    const char * const name = MethodName(metrics[m].method);
+    output << "True " << name << " = " << metrics[m].trueValue << endl;
+    output << "Average " << name << " = " << totals[m];
+    output << " / " << samples << " = ";
+    double average = totals[m] / samples;
+    output << average << endl;
+  }
 
-  return average;
+  return;
 }
-
@@ -20,6 +20,8 @@
 void Run(const char * const historicFilename,
          const char * const detailFilename,
          const bool verboseOn,
+         const bool useMappedFiles,
+         const bool useCache,
          const bool outputToFile,
          const bool generateReport,
          const bool generateNewick,
@@ -28,6 +30,11 @@ void Run(const char * const historicFilename,
          const bool calcBalance,
          unsigned int samples,
          unsigned int leavesToSample,
-         unsigned int timeCutoff);
+         unsigned int timeCutoff,
+         unsigned int threads,
+         const int seed,
+         const int bornCutoff,
+         const int followSeconds,
+         const unsigned int refreshes);
 
 #endif // __ProgramInterface_h__
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __Support_Interface_Arena_h__
+#define __Support_Interface_Arena_h__
+
+#include <cstddef>
+#include <vector>
+
+// Arena hands out memory from large blocks by moving a pointer forward.
+//   Nothing is freed individually; every allocation is released at once by
+//   Clear or the destructor, so it suits data that all lives as long as a
+//   load.  Objects placed in an arena never have their destructors run.
+//   An arena must only be used by one thread at a time.
+class Arena
+{
+private:
+  // Full sized blocks in use, blocks of other sizes (large requests and
+  //   adopted blocks), and full sized blocks kept by Reset.
+  std::vector<char*> blocks;
+  std::vector<char*> others;
+  std::vector<char*> spare;
+  char *next;
+  std::size_t remaining;
+  std::size_t blockSize;
+  std::size_t used;
+
+public:
+  explicit Arena(const std::size_t blockSize = 1 << 20);
+  ~Arena(void);
+
+  // Returns size bytes aligned to alignment, which must be a power of two.
+  void *Allocate(const std::size_t size,
+                 const std::size_t alignment = sizeof(double));
+  // Copies the characters [begin, end) and adds a null terminator.
+  char *Copy(const char * const begin, const char * const end);
+
+  // Takes over all of the other arena's memory, leaving it empty.  Anything
+  //   allocated from the other arena stays valid.
+  void Adopt(Arena &other);
+  void Clear(void);
+  // Like Clear, but keeps the full sized blocks to hand out again, so
+  //   filling the arena to the same size again allocates nothing.
+  void Reset(void);
+
+  // Bytes handed out so far.
+  const std::size_t Size(void) const { return used; }
+
+private:
+  char *NewBlock(void);
+
+  Arena(const Arena &);
+  const Arena &operator=(const Arena &);
+};
+
+#endif // __Support_Interface_Arena_h__
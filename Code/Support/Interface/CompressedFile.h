@@ -0,0 +1,121 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __Support_Interface_CompressedFile_h__
+#define __Support_Interface_CompressedFile_h__
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+// CompressedFile reads a gzip compressed file (or a zstd compressed one when
+//   built with TREELOADER_ZSTD defined) as a stream of its decompressed
+//   contents, e.g. through std::istream in(&file).
+//
+// Decompression runs on its own thread, which fills a small ring of blocks
+//   ahead of the reader.  The ring is bounded, so memory use does not
+//   depend on the size of the file, and the reader only waits when it has
+//   caught up with the decompressor.
+class CompressedFile : public std::streambuf
+{
+public:
+  enum Format
+  {
+    Plain,
+    Gzip,
+    Zstd
+  };
+
+private:
+  struct Block
+  {
+    std::vector<char> data;
+    std::size_t       size;
+  };
+
+  std::FILE  *file;
+  Format      format;
+  bool        isOpen;
+  std::size_t blockSize;
+
+  std::thread reader;
+
+  // The ring of blocks, guarded by lock.  Blocks [next, next + filled) hold
+  //   data that has not been released by the consumer yet; the first of them
+  //   is the one being read while current is true.
+  std::mutex              lock;
+  std::condition_variable blockFilled;
+  std::condition_variable blockReleased;
+  std::vector<Block>      blocks;
+  std::size_t             next;
+  std::size_t             filled;
+  bool                    current;
+  bool                    finished;
+  bool                    failed;
+  bool                    stopping;
+
+  std::size_t inputSize;
+  std::size_t outputSize;
+
+public:
+  explicit CompressedFile(const std::size_t blockSize = 1<<20,
+                          const std::size_t blockCount = 4);
+  ~CompressedFile(void);
+
+  // Returns the compression format of the file from its first bytes, Plain
+  //   if it is not compressed or can not be read.
+  static const Format DetectFormat(const char * const filename);
+  // Returns false if this build can not decompress the format.
+  static const bool   IsSupported(const Format);
+
+  // Throws 1 if the file can not be opened and 2 if it is not in a
+  //   supported compressed format.
+  void Open(const char * const filename) throw(int);
+  void Close(void);
+
+  const bool        IsOpen(void) const { return isOpen; }
+  const Format      GetFormat(void) const { return format; }
+  // Size of the compressed file.
+  const std::size_t Size(void) const { return inputSize; }
+  // Decompressed bytes handed to the reader so far.
+  const std::size_t DecompressedSize(void) const { return outputSize; }
+  // True if the file was damaged or truncated.  The stream ends at the
+  //   damage, so check this once the stream has been read.
+  const bool        Failed(void);
+
+protected:
+  int_type underflow(void);
+
+private:
+  void ReadAhead(void);
+  void InflateGzip(void);
+  void DecompressZstd(void);
+
+  // Decompressor side of the ring: waits for a free block or returns 0 if
+  //   the file is being closed, and hands a filled block to the reader.
+  Block *NextFree(void);
+  void   Fill(void);
+  void   Finish(const bool failure);
+
+  CompressedFile(const CompressedFile &);
+  const CompressedFile &operator=(const CompressedFile &);
+};
+
+#endif // __Support_Interface_CompressedFile_h__
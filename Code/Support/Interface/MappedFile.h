@@ -0,0 +1,53 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __Support_Interface_MappedFile_h__
+#define __Support_Interface_MappedFile_h__
+
+#include <cstddef>
+
+// MappedFile provides read-only access to the entire contents of a file as
+//   one contiguous range of characters.  Where mmap is available the file is
+//   mapped into memory so its pages are read in place without being copied,
+//   otherwise the file is read into a single buffer.  The range is not null
+//   terminated.
+class MappedFile
+{
+private:
+  char *data;
+  std::size_t size;
+  bool mapped;
+  bool isOpen;
+
+public:
+  MappedFile(void);
+  ~MappedFile(void);
+
+  // Throws 1 if the file can not be opened and 2 if it can not be read.
+  void Open(const char * const filename) throw(int);
+  void Close(void);
+
+  const bool        IsOpen(void) const { return isOpen;      }
+  const char       *Begin(void)  const { return data;        }
+  const char       *End(void)    const { return data + size; }
+  const std::size_t Size(void)   const { return size;        }
+
+private:
+  MappedFile(const MappedFile &);
+  const MappedFile &operator=(const MappedFile &);
+};
+
+#endif // __Support_Interface_MappedFile_h__
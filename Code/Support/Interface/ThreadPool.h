@@ -0,0 +1,69 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __Support_Interface_ThreadPool_h__
+#define __Support_Interface_ThreadPool_h__
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ThreadPool keeps a fixed set of worker threads for running batches of
+//   independent tasks.  A pool of size one (or zero) has no workers and
+//   runs every task on the calling thread.
+class ThreadPool
+{
+private:
+  std::vector<std::thread> workers;
+
+  std::mutex lock;
+  std::condition_variable workReady;
+  std::condition_variable workDone;
+
+  // The batch currently being run, guarded by lock.
+  const std::function<void(unsigned int)> *current;
+  unsigned int taskCount;
+  unsigned int nextTask;
+  unsigned int tasksRunning;
+  std::exception_ptr failure;
+  bool stopping;
+
+public:
+  explicit ThreadPool(const unsigned int threads);
+  ~ThreadPool(void);
+
+  const unsigned int Size(void) const;
+
+  // Calls task(i) for every i in [0, count) using all of the threads in
+  //   the pool, the calling thread included, and returns once all of them
+  //   have finished.  Tasks may run in any order.  If a task throws, the
+  //   remaining tasks are skipped and the first exception is rethrown here.
+  //   Tasks must not call Run on the pool running them.
+  void Run(const unsigned int count,
+           const std::function<void(unsigned int)> &task);
+
+private:
+  void Work(void);
+  const bool RunNext(std::unique_lock<std::mutex> &);
+
+  ThreadPool(const ThreadPool &);
+  const ThreadPool &operator=(const ThreadPool &);
+};
+
+#endif // __Support_Interface_ThreadPool_h__
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include "Support/Interface/Arena.h"
+
+using namespace std;
+
+Arena::Arena(const size_t size)
+: next(0), remaining(0), blockSize(size), used(0)
+{
+  return;
+}
+
+Arena::~Arena(void)
+{
+  Clear();
+  return;
+}
+
+void *Arena::Allocate(const size_t size, const size_t alignment)
+{
+  size_t padding = reinterpret_cast<size_t>(next) & (alignment - 1);
+  if(padding != 0) { padding = alignment - padding; }
+
+  if(next == 0 || padding + size > remaining)
+  {
+    // Large requests get a block of their own so that the rest of the
+    //   current block is not wasted.
+    if(size + alignment > blockSize / 4)
+    {
+      char *block = new char[size + alignment];
+      others.push_back(block);
+      size_t offset = reinterpret_cast<size_t>(block) & (alignment - 1);
+      if(offset != 0) { offset = alignment - offset; }
+      used += size;
+      return block + offset;
+    }
+
+    next = NewBlock();
+    remaining = blockSize;
+
+    padding = reinterpret_cast<size_t>(next) & (alignment - 1);
+    if(padding != 0) { padding = alignment - padding; }
+  }
+
+  char *memory = next + padding;
+  next = memory + size;
+  remaining -= padding + size;
+  used += size;
+
+  return memory;
+}
+
+char *Arena::Copy(const char * const begin, const char * const end)
+{
+  const size_t length = static_cast<size_t>(end - begin);
+  char *copy = static_cast<char*>(Allocate(length + 1, 1));
+  memcpy(copy, begin, length);
+  copy[length] = '\0';
+
+  return copy;
+}
+
+void Arena::Adopt(Arena &other)
+{
+  if(&other == this) { return; }
+
+  // This arena keeps filling its own current block.  The other arena's
+  //   blocks may be of another size, so they are never reused.
+  others.insert(others.end(), other.blocks.begin(), other.blocks.end());
+  others.insert(others.end(), other.others.begin(), other.others.end());
+  used += other.used;
+
+  other.blocks.clear();
+  other.others.clear();
+  other.next = 0;
+  other.remaining = 0;
+  other.used = 0;
+
+  return;
+}
+
+void Arena::Clear(void)
+{
+  Reset();
+
+  vector<char*>::iterator i = spare.begin();
+  for(; i != spare.end(); ++i) { delete [] *i; }
+
+  // swap with empty vectors to release their memory as well
+  vector<char*>().swap(blocks);
+  vector<char*>().swap(others);
+  vector<char*>().swap(spare);
+
+  return;
+}
+
+void Arena::Reset(void)
+{
+  vector<char*>::iterator i = others.begin();
+  for(; i != others.end(); ++i) { delete [] *i; }
+  others.clear();
+
+  spare.insert(spare.end(), blocks.begin(), blocks.end());
+  blocks.clear();
+  next = 0;
+  remaining = 0;
+  used = 0;
+
+  return;
+}
+
+char *Arena::NewBlock(void)
+{
+  char *block = 0;
+  if(!spare.empty())
+  {
+    block = spare.back();
+    spare.pop_back();
+  }
+  else
+  {
+    block = new char[blockSize];
+  }
+  blocks.push_back(block);
+
+  return block;
+}
@@ -0,0 +1,364 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+
+#include <zlib.h>
+#if defined(TREELOADER_ZSTD)
+#include <zstd.h>
+#endif
+
+#include "Support/Interface/CompressedFile.h"
+
+using namespace std;
+
+// Size of the compressed reads that feed the decompressor.
+static const size_t compressedReadSize = 1<<18;
+
+CompressedFile::CompressedFile(const size_t blockSize,
+                               const size_t blockCount)
+: file(0), format(Plain), isOpen(false), blockSize(blockSize),
+  blocks((blockCount > 1) ? blockCount : 2), next(0), filled(0),
+  current(false), finished(false), failed(false), stopping(false),
+  inputSize(0), outputSize(0)
+{
+  return;
+}
+
+CompressedFile::~CompressedFile(void)
+{
+  Close();
+  return;
+}
+
+const CompressedFile::Format
+CompressedFile::DetectFormat(const char * const filename)
+{
+  if(filename == 0) { return Plain; }
+
+  FILE *in = fopen(filename, "rb");
+  if(in == 0) { return Plain; }
+
+  unsigned char magic[4] = {0, 0, 0, 0};
+  const size_t count = fread(magic, 1, sizeof(magic), in);
+  fclose(in);
+
+  if(count >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) { return Gzip; }
+  if(count == 4 && magic[0] == 0x28 && magic[1] == 0xb5 &&
+     magic[2] == 0x2f && magic[3] == 0xfd)
+  {
+    return Zstd;
+  }
+
+  return Plain;
+}
+
+const bool CompressedFile::IsSupported(const Format f)
+{
+  switch(f)
+  {
+  case Gzip:
+    return true;
+  case Zstd:
+#if defined(TREELOADER_ZSTD)
+    return true;
+#else
+    return false;
+#endif
+  default:
+    return false;
+  }
+}
+
+void CompressedFile::Open(const char * const filename) throw(int)
+{
+  Close();
+
+  if(filename == 0) { throw 1; }
+  const Format f = DetectFormat(filename);
+
+  file = fopen(filename, "rb");
+  if(file == 0) { throw 1; }
+  if(!IsSupported(f))
+  {
+    fclose(file);
+    file = 0;
+    throw 2;
+  }
+
+  fseek(file, 0, SEEK_END);
+  const long end = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  inputSize = (end > 0) ? static_cast<size_t>(end) : 0;
+
+  for(size_t i = 0; i < blocks.size(); ++i)
+  {
+    blocks[i].data.resize(blockSize);
+    blocks[i].size = 0;
+  }
+
+  format = f;
+  isOpen = true;
+  reader = thread(&CompressedFile::ReadAhead, this);
+
+  return;
+}
+
+void CompressedFile::Close(void)
+{
+  if(reader.joinable())
+  {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+    }
+    blockReleased.notify_all();
+    reader.join();
+  }
+
+  if(file != 0) { fclose(file); }
+
+  file = 0;
+  format = Plain;
+  isOpen = false;
+  next = 0;
+  filled = 0;
+  current = false;
+  finished = false;
+  failed = false;
+  stopping = false;
+  inputSize = 0;
+  outputSize = 0;
+  setg(0, 0, 0);
+
+  for(size_t i = 0; i < blocks.size(); ++i)
+  {
+    vector<char>().swap(blocks[i].data);
+  }
+
+  return;
+}
+
+const bool CompressedFile::Failed(void)
+{
+  lock_guard<mutex> guard(lock);
+  return failed;
+}
+
+CompressedFile::int_type CompressedFile::underflow(void)
+{
+  if(!isOpen) { return traits_type::eof(); }
+
+  unique_lock<mutex> guard(lock);
+
+  // Hand the block that was just read back to the decompressor.
+  if(current)
+  {
+    next = (next + 1) % blocks.size();
+    --filled;
+    current = false;
+    blockReleased.notify_one();
+  }
+
+  while(filled == 0 && !finished) { blockFilled.wait(guard); }
+  if(filled == 0)
+  {
+    setg(0, 0, 0);
+    return traits_type::eof();
+  }
+
+  Block &block = blocks[next];
+  current = true;
+  outputSize += block.size;
+  setg(&block.data[0], &block.data[0], &block.data[0] + block.size);
+
+  return traits_type::to_int_type(block.data[0]);
+}
+
+void CompressedFile::ReadAhead(void)
+{
+  try
+  {
+    if(format == Gzip) { InflateGzip(); }
+    else               { DecompressZstd(); }
+  }
+  catch(...)
+  {
+    Finish(true);
+  }
+
+  return;
+}
+
+void CompressedFile::InflateGzip(void)
+{
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+
+  // 15 + 32 accepts both gzip and zlib headers.
+  if(inflateInit2(&stream, 15 + 32) != Z_OK)
+  {
+    Finish(true);
+    return;
+  }
+
+  vector<unsigned char> input(compressedReadSize);
+  Block *block = NextFree();
+  bool failure = false;
+  bool drained = true;
+  bool ended = false;
+  while(block != 0)
+  {
+    // Only read more once inflate has nothing left to write.
+    if(stream.avail_in == 0 && drained)
+    {
+      const size_t count = fread(&input[0], 1, input.size(), file);
+      if(count == 0) { break; }
+      stream.next_in = &input[0];
+      stream.avail_in = static_cast<uInt>(count);
+    }
+
+    // gzip allows several members in a row, e.g. from appending to a file.
+    if(ended && stream.avail_in > 0)
+    {
+      if(inflateReset(&stream) != Z_OK) { failure = true; break; }
+      ended = false;
+    }
+
+    stream.next_out = reinterpret_cast<Bytef*>(&block->data[0] + block->size);
+    stream.avail_out = static_cast<uInt>(block->data.size() - block->size);
+
+    const int result = inflate(&stream, Z_NO_FLUSH);
+    block->size = block->data.size() - stream.avail_out;
+    drained = (stream.avail_out != 0);
+
+    if(result == Z_STREAM_END)
+    {
+      ended = true;
+      drained = true;
+    }
+    else if(result != Z_OK && result != Z_BUF_ERROR)
+    {
+      failure = true;
+      break;
+    }
+
+    if(block->size == block->data.size())
+    {
+      Fill();
+      block = NextFree();
+    }
+  }
+
+  inflateEnd(&stream);
+  if(block == 0) { return; }
+
+  if(block->size > 0) { Fill(); }
+  Finish(failure || !ended || ferror(file) != 0);
+
+  return;
+}
+
+void CompressedFile::DecompressZstd(void)
+{
+#if defined(TREELOADER_ZSTD)
+  ZSTD_DCtx *context = ZSTD_createDCtx();
+  if(context == 0)
+  {
+    Finish(true);
+    return;
+  }
+
+  vector<char> buffer(ZSTD_DStreamInSize());
+  ZSTD_inBuffer input = {&buffer[0], 0, 0};
+  Block *block = NextFree();
+  bool failure = false;
+  bool drained = true;
+  size_t remaining = 0;
+  while(block != 0)
+  {
+    if(input.pos == input.size && drained)
+    {
+      const size_t count = fread(&buffer[0], 1, buffer.size(), file);
+      if(count == 0) { break; }
+      input.size = count;
+      input.pos = 0;
+    }
+
+    ZSTD_outBuffer output = {&block->data[0], block->data.size(), block->size};
+    remaining = ZSTD_decompressStream(context, &output, &input);
+    if(ZSTD_isError(remaining))
+    {
+      failure = true;
+      break;
+    }
+    block->size = output.pos;
+    drained = (output.pos != output.size);
+
+    if(block->size == block->data.size())
+    {
+      Fill();
+      block = NextFree();
+    }
+  }
+
+  ZSTD_freeDCtx(context);
+  if(block == 0) { return; }
+
+  // A non-zero hint means the last frame was cut short.
+  if(block->size > 0) { Fill(); }
+  Finish(failure || remaining != 0 || ferror(file) != 0);
+#else
+  Finish(true);
+#endif
+
+  return;
+}
+
+CompressedFile::Block *CompressedFile::NextFree(void)
+{
+  unique_lock<mutex> guard(lock);
+  while(filled == blocks.size() && !stopping) { blockReleased.wait(guard); }
+  if(stopping) { return 0; }
+
+  Block &block = blocks[(next + filled) % blocks.size()];
+  block.size = 0;
+
+  return &block;
+}
+
+void CompressedFile::Fill(void)
+{
+  {
+    lock_guard<mutex> guard(lock);
+    ++filled;
+  }
+  blockFilled.notify_one();
+
+  return;
+}
+
+void CompressedFile::Finish(const bool failure)
+{
+  {
+    lock_guard<mutex> guard(lock);
+    finished = true;
+    failed = failure;
+  }
+  blockFilled.notify_one();
+
+  return;
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <fstream>
+#endif
+
+#include "Support/Interface/MappedFile.h"
+
+using namespace std;
+
+MappedFile::MappedFile(void)
+: data(0), size(0), mapped(false), isOpen(false)
+{
+  return;
+}
+
+MappedFile::~MappedFile(void)
+{
+  Close();
+  return;
+}
+
+void MappedFile::Close(void)
+{
+  if(data != 0)
+  {
+#if !defined(_WIN32)
+    if(mapped) { munmap(data, size); }
+    else       { delete [] data;     }
+#else
+    delete [] data;
+#endif
+  }
+
+  data = 0;
+  size = 0;
+  mapped = false;
+  isOpen = false;
+
+  return;
+}
+
+void MappedFile::Open(const char * const filename) throw(int)
+{
+  Close();
+
+  if(filename == 0) { throw 1; }
+
+#if !defined(_WIN32)
+  int fd = open(filename, O_RDONLY);
+  if(fd < 0) { throw 1; }
+
+  struct stat info;
+  if(fstat(fd, &info) != 0)
+  {
+    close(fd);
+    throw 2;
+  }
+
+  size = static_cast<size_t>(info.st_size);
+
+  // An empty file can not be mapped, but it is still a valid (empty) range.
+  if(size > 0)
+  {
+    void *address = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(address == MAP_FAILED)
+    {
+      close(fd);
+      size = 0;
+      throw 2;
+    }
+
+    // The file is always read front to back so let the kernel read ahead.
+    madvise(address, size, MADV_SEQUENTIAL);
+
+    data = static_cast<char*>(address);
+    mapped = true;
+  }
+
+  // The mapping remains valid after the descriptor is closed.
+  close(fd);
+#else
+  ifstream in(filename, ios::in | ios::binary);
+  if(!in) { throw 1; }
+
+  in.seekg(0, ios::end);
+  size = static_cast<size_t>(in.tellg());
+  in.seekg(0, ios::beg);
+
+  if(size > 0)
+  {
+    data = new char[size];
+    in.read(data, static_cast<streamsize>(size));
+    if(static_cast<size_t>(in.gcount()) != size)
+    {
+      Close();
+      throw 2;
+    }
+  }
+#endif
+
+  isOpen = true;
+
+  return;
+}
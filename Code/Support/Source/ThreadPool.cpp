@@ -0,0 +1,121 @@
+/**
+ * Copyright 2010 Jason Stredwick
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Support/Interface/ThreadPool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(const unsigned int threads)
+: current(0),
+  taskCount(0),
+  nextTask(0),
+  tasksRunning(0),
+  stopping(false)
+{
+  // The thread calling Run also works, so it needs one fewer worker.
+  for(unsigned int i = 1; i < threads; ++i)
+  {
+    workers.push_back(thread(&ThreadPool::Work, this));
+  }
+
+  return;
+}
+
+ThreadPool::~ThreadPool(void)
+{
+  {
+    unique_lock<mutex> guard(lock);
+    stopping = true;
+  }
+  workReady.notify_all();
+
+  vector<thread>::iterator i = workers.begin();
+  for(; i != workers.end(); ++i) { i->join(); }
+
+  return;
+}
+
+const unsigned int ThreadPool::Size(void) const
+{
+  return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+void ThreadPool::Run(const unsigned int count,
+                     const function<void(unsigned int)> &task)
+{
+  if(count == 0) { return; }
+
+  unique_lock<mutex> guard(lock);
+  current = &task;
+  taskCount = count;
+  nextTask = 0;
+  tasksRunning = 0;
+  failure = exception_ptr();
+  workReady.notify_all();
+
+  // Help out, then wait for the tasks the workers are still running.
+  while(RunNext(guard)) {}
+  while(tasksRunning > 0) { workDone.wait(guard); }
+
+  exception_ptr taskFailure = failure;
+  current = 0;
+  taskCount = 0;
+  nextTask = 0;
+  failure = exception_ptr();
+  guard.unlock();
+
+  if(taskFailure) { rethrow_exception(taskFailure); }
+
+  return;
+}
+
+const bool ThreadPool::RunNext(unique_lock<mutex> &guard)
+{
+  if(nextTask >= taskCount) { return false; }
+
+  const unsigned int index = nextTask++;
+  ++tasksRunning;
+
+  // Run the task without holding the lock.
+  guard.unlock();
+  exception_ptr taskFailure;
+  try { (*current)(index); }
+  catch(...) { taskFailure = current_exception(); }
+  guard.lock();
+
+  --tasksRunning;
+  if(taskFailure)
+  {
+    // Keep the first failure and skip the tasks that have not started.
+    if(!failure) { failure = taskFailure; }
+    nextTask = taskCount;
+  }
+  if(nextTask >= taskCount && tasksRunning == 0) { workDone.notify_all(); }
+
+  return true;
+}
+
+void ThreadPool::Work(void)
+{
+  unique_lock<mutex> guard(lock);
+  while(true)
+  {
+    while(!stopping && nextTask >= taskCount) { workReady.wait(guard); }
+    if(stopping) { return; }
+
+    while(RunNext(guard)) {}
+  }
+}
@@ -15,14 +15,18 @@
  */
 
 #include <iostream>
+#include <climits>
 #include <cstring>
 #include <cstdlib>
+#include <thread>
 
 #include "ProgramInterface.h"
 
 using namespace std;
 
 void HowTo(void);
+const bool ReadNumber(const char * const text, const long low,
+                      const long high, long &value);
 
 int main(int argc, char **argv)
 {
@@ -33,6 +37,8 @@ int main(int argc, char **argv)
   bool calcBalance = false;
 
   bool verboseOn = false;
+  bool useMappedFiles = false;
+  bool useCache = false;
   bool outputToFile = false;
   bool generateReport = false;
   bool generateNewick = false;
@@ -40,6 +46,11 @@ int main(int argc, char **argv)
   unsigned int samples = 0;
   unsigned int leavesToSample = 0;
   unsigned int timeCutoff = 0;
+  unsigned int threads = 1;
+  int seed = -1;
+  int bornCutoff = -1;
+  int followSeconds = -1;
+  unsigned int refreshes = 0;
   char *historicFilename = 0;
   char *detailFilename = 0;
 
@@ -60,6 +71,14 @@ int main(int argc, char **argv)
     {
       verboseOn = true;
     }
+    else if(strcmp(argv[i], "-mmap") == 0)
+    {
+      useMappedFiles = true;
+    }
+    else if(strcmp(argv[i], "-cache") == 0)
+    {
+      useCache = true;
+    }
     else if(strcmp(argv[i], "-f") == 0)
     {
       outputToFile = true;
@@ -96,6 +115,78 @@ int main(int argc, char **argv)
       leavesToSample = atoi(argv[i+1]);
       ++i;
     }
+    else if(strcmp(argv[i], "-j") == 0)
+    {
+      if(argc <= i+1) { HowTo(); return 0; }
+
+      // More threads than a few per core only costs memory and switching.
+      const int cores = static_cast<int>(thread::hardware_concurrency());
+      const int maxThreads = 4 * ((cores > 0) ? cores : 1);
+      const int requested = atoi(argv[i+1]);
+      if(requested < 1 || requested > maxThreads)
+      {
+        cout << "-j takes between 1 and " << maxThreads << " threads." << endl;
+        HowTo();
+        return 0;
+      }
+      threads = static_cast<unsigned int>(requested);
+      ++i;
+    }
+    else if(strcmp(argv[i], "-seed") == 0)
+    {
+      if(argc <= i+1) { HowTo(); return 0; }
+      // Reported seeds lie in the range the generator keeps, and 0 is one
+      //   of them, so anything that is not a number in it is refused.
+      long requested = 0;
+      if(!ReadNumber(argv[i+1], 0, 161803397, requested))
+      {
+        cout << "-seed takes a number between 0 and 161803397." << endl;
+        HowTo();
+        return 0;
+      }
+      seed = static_cast<int>(requested);
+      ++i;
+    }
+    else if(strcmp(argv[i], "-born") == 0)
+    {
+      if(argc <= i+1) { HowTo(); return 0; }
+      long update = 0;
+      if(!ReadNumber(argv[i+1], 0, INT_MAX, update))
+      {
+        cout << "-born takes an update of 0 or more." << endl;
+        HowTo();
+        return 0;
+      }
+      bornCutoff = static_cast<int>(update);
+      ++i;
+    }
+    else if(strcmp(argv[i], "-follow") == 0)
+    {
+      if(argc <= i+1) { HowTo(); return 0; }
+      long seconds = 0;
+      if(!ReadNumber(argv[i+1], 0, INT_MAX, seconds))
+      {
+        cout << "-follow takes a number of seconds, 0 or more." << endl;
+        HowTo();
+        return 0;
+      }
+      followSeconds = static_cast<int>(seconds);
+      ++i;
+    }
+    else if(strcmp(argv[i], "-refreshes") == 0)
+    {
+      if(argc <= i+1) { HowTo(); return 0; }
+      // 0 keeps following until the program is stopped.
+      long count = 0;
+      if(!ReadNumber(argv[i+1], 0, INT_MAX, count))
+      {
+        cout << "-refreshes takes a count of 0 or more." << endl;
+        HowTo();
+        return 0;
+      }
+      refreshes = static_cast<unsigned int>(count);
+      ++i;
+    }
     else if(strcmp(argv[i], "-t") == 0)
     {
       if(argc <= i+1) { HowTo(); return 0; }
@@ -105,9 +196,10 @@ int main(int argc, char **argv)
     else { HowTo(); return 0; }
   }
 
-  Run(historicFilename, detailFilename, verboseOn, outputToFile, 
-      generateReport, generateNewick, calcGamma, calcNCStem, calcBalance,
-      samples, leavesToSample, timeCutoff);
+  Run(historicFilename, detailFilename, verboseOn, useMappedFiles, useCache,
+      outputToFile, generateReport, generateNewick, calcGamma, calcNCStem, calcBalance,
+      samples, leavesToSample, timeCutoff, threads, seed, bornCutoff,
+      followSeconds, refreshes);
 
   return 0;
 }
@@ -122,15 +214,43 @@ void HowTo(void)
   cout << endl;
   cout << "  -s [how_many_samples]            optional" << endl;
   cout << "  -l [quantity_leafs_to_sample]    optional" << endl;
+  cout << "  -j [threads]                     optional (implies -mmap)" << endl;
+  cout << "  -seed [number]                   optional (repeat the samples" << endl;
+  cout << "                                   of a run with this seed," << endl;
+  cout << "                                   0 to 161803397)" << endl;
+  cout << "  -born [update]                   optional (only load organisms" << endl;
+  cout << "                                   born by this update)" << endl;
+  cout << "  -follow [seconds]                optional (keep reading records" << endl;
+  cout << "                                   appended to the historic file)" << endl;
+  cout << "  -refreshes [count]               optional (stop following after" << endl;
+  cout << "                                   this many checks)" << endl;
   cout << endl;
   cout << "  -g                               (run gamma calculation)" << endl;
   cout << "  -ncstem                          (run NC Stem calculation)" << endl;
   cout << "  -b                               (run balance calculation)" << endl;
   cout << endl;
   cout << "  -v                               (verbose output on)" << endl;
+  cout << "  -mmap                            (memory map input files)" << endl;
+  cout << "  -cache                           (reuse or save the prepared tree)" << endl;
   cout << "  -f                               (generator output files)" << endl;
   cout << "  -r                               (generate report files)" << endl;
   cout << "  -n                               (generate newick files)" << endl;
 
   return;
 }
+
+const bool ReadNumber(const char * const text, const long low,
+                      const long high, long &value)
+{
+  // The whole argument must be a number, unlike with atoi, so a typo is
+  //   not taken as 0.
+  char *end = 0;
+  const long number = strtol(text, &end, 10);
+  if(end == text || *end != '\0' || number < low || number > high)
+  {
+    return false;
+  }
+
+  value = number;
+  return true;
+}